@@ -0,0 +1,190 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../utils/hash_table.h"
+#include "../utils/typed_hash_table.h"
+#include "bench.h"
+
+/*
+ * Measures HashTable, or a typed table from typed_hash_table.h, with random 64-bit keys: inserting them all, looking
+ * each up three times, looking up as many absent keys three times, and removing them all. Every run then checks the
+ * results it timed, so the benchmark also exercises each engine end to end. Built against utils/open_hash_table.c as
+ * bin/bench_hash_table, against the same file without SSE2 as bin/bench_hash_table_scalar, and against
+ * bench/chained_hash_table.c, which has a single layout and ignores the engine, as bin/bench_hash_table_chained.
+ *
+ * Usage: bench_hash_table [robin_hood|swiss|typed] [num_keys]; by default it runs Robin Hood with 200k and 2M keys.
+ */
+
+#define NUM_LOOKUP_ROUNDS 3
+
+DEFINE_TYPED_HASH_TABLE(KeyTable, key_table, uint64_t, uint32_t, typed_hash_uint64, typed_equal_uint64)
+
+typedef struct {
+    int num_keys;
+    uint64_t* keys;
+    uint64_t* shuffled;
+    uint64_t* absent;
+    double start;
+    double inserted;
+    double hit;
+    double missed;
+    double checked;
+    double removed;
+    int num_errors;
+} Run;
+
+/* Lookup results are summed into it, so the lookups are not optimised away. */
+volatile uintptr_t lookup_sum;
+
+int _hash_address(void* key, int size) {
+    return (int)((uintptr_t)key % (uintptr_t)size);
+}
+
+bool _equal_addresses(void* key1, void* key2) {
+    return key1 == key2;
+}
+
+/*
+ * Random keys from one generator are inserted, and random keys from another are the misses. Hits look the keys up in
+ * a shuffled order, since in insertion order they would walk nodes allocated one after another.
+ */
+void _make_keys(Run* run, int num_keys) {
+    run->num_keys = num_keys;
+    run->keys = malloc(sizeof(uint64_t) * num_keys);
+    run->shuffled = malloc(sizeof(uint64_t) * num_keys);
+    run->absent = malloc(sizeof(uint64_t) * num_keys);
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    uint64_t absent_state = 0x243f6a8885a308d3ULL;
+    for (int i = 0; i < num_keys; i++) {
+        run->keys[i] = bench_random(&state);
+        run->absent[i] = bench_random(&absent_state);
+        int j = bench_random(&state) % (i + 1);
+        run->shuffled[i] = run->shuffled[j];
+        run->shuffled[j] = run->keys[i];
+    }
+    run->num_errors = 0;
+}
+
+/* Counts the lookups that did not find what was inserted, or found what was not. */
+void _check(Run* run, HashTable table, bool removed) {
+    run->num_errors += hash_table_size(table) != (removed ? 0 : run->num_keys);
+    for (int i = 0; i < run->num_keys; i++) {
+        uintptr_t expected = removed ? 0 : (uintptr_t)(i + 1);
+        run->num_errors += (uintptr_t)hash_table_get(table, (void*)(uintptr_t)run->keys[i]) != expected;
+        run->num_errors += hash_table_get(table, (void*)(uintptr_t)run->absent[i]) != NULL;
+    }
+}
+
+void _check_typed(Run* run, KeyTable* table, bool removed) {
+    run->num_errors += table->size != (removed ? 0 : (uint32_t)run->num_keys);
+    for (int i = 0; i < run->num_keys; i++) {
+        uint32_t* value = key_table_get(table, run->keys[i]);
+        run->num_errors += removed ? value != NULL : value == NULL || *value != (uint32_t)(i + 1);
+        run->num_errors += key_table_get(table, run->absent[i]) != NULL;
+    }
+}
+
+void _run(Run* run, HashTableEngine engine) {
+    HashTable table = hash_table_create_with_engine(engine, DEFAULT_SIZE, _hash_address, _equal_addresses, NULL);
+    uintptr_t sum = 0;
+    run->start = bench_now();
+    for (int i = 0; i < run->num_keys; i++) {
+        hash_table_insert(table, (void*)(uintptr_t)run->keys[i], (void*)(uintptr_t)(i + 1));
+    }
+    run->inserted = bench_now();
+    for (int round = 0; round < NUM_LOOKUP_ROUNDS; round++) {
+        for (int i = 0; i < run->num_keys; i++) {
+            sum += (uintptr_t)hash_table_get(table, (void*)(uintptr_t)run->shuffled[i]);
+        }
+    }
+    run->hit = bench_now();
+    for (int round = 0; round < NUM_LOOKUP_ROUNDS; round++) {
+        for (int i = 0; i < run->num_keys; i++) {
+            sum += (uintptr_t)hash_table_get(table, (void*)(uintptr_t)run->absent[i]);
+        }
+    }
+    run->missed = bench_now();
+    _check(run, table, false);
+    run->checked = bench_now();
+    for (int i = 0; i < run->num_keys; i++) {
+        hash_table_remove(table, (void*)(uintptr_t)run->keys[i]);
+    }
+    run->removed = bench_now();
+    _check(run, table, true);
+    lookup_sum = sum;
+    hash_table_destroy(table, NULL);
+}
+
+void _run_typed(Run* run) {
+    KeyTable table;
+    key_table_init(&table, DEFAULT_SIZE);
+    uintptr_t sum = 0;
+    run->start = bench_now();
+    for (int i = 0; i < run->num_keys; i++) {
+        key_table_insert(&table, run->keys[i], i + 1);
+    }
+    run->inserted = bench_now();
+    for (int round = 0; round < NUM_LOOKUP_ROUNDS; round++) {
+        for (int i = 0; i < run->num_keys; i++) {
+            sum += *key_table_get(&table, run->shuffled[i]);
+        }
+    }
+    run->hit = bench_now();
+    for (int round = 0; round < NUM_LOOKUP_ROUNDS; round++) {
+        for (int i = 0; i < run->num_keys; i++) {
+            sum += key_table_get(&table, run->absent[i]) != NULL;
+        }
+    }
+    run->missed = bench_now();
+    _check_typed(run, &table, false);
+    run->checked = bench_now();
+    for (int i = 0; i < run->num_keys; i++) {
+        key_table_remove(&table, run->keys[i], NULL);
+    }
+    run->removed = bench_now();
+    _check_typed(run, &table, true);
+    lookup_sum = sum;
+    key_table_destroy(&table);
+}
+
+/* Runs one benchmark, with engine -1 for the typed table, and returns its number of wrong results. */
+int _bench(int engine, int num_keys) {
+    Run run;
+    _make_keys(&run, num_keys);
+    if (engine < 0) {
+        _run_typed(&run);
+    } else {
+        _run(&run, engine);
+    }
+    double lookups = (double)NUM_LOOKUP_ROUNDS * num_keys;
+    printf("%8d keys:  insert %4.0f ns  hit %4.0f ns  miss %4.0f ns  remove %4.0f ns%s\n", num_keys,
+           (run.inserted - run.start) / num_keys * 1e9, (run.hit - run.inserted) / lookups * 1e9,
+           (run.missed - run.hit) / lookups * 1e9, (run.removed - run.checked) / num_keys * 1e9,
+           run.num_errors != 0 ? "  WRONG RESULTS" : "");
+    free(run.keys);
+    free(run.shuffled);
+    free(run.absent);
+    return run.num_errors;
+}
+
+int main(int argc, char* argv[]) {
+    int engine = HASH_TABLE_ROBIN_HOOD;
+    if (argc > 1 && strcmp(argv[1], "swiss") == 0) {
+        engine = HASH_TABLE_SWISS;
+    } else if (argc > 1 && strcmp(argv[1], "typed") == 0) {
+        engine = -1;
+    } else if (argc > 1 && strcmp(argv[1], "robin_hood") != 0) {
+        fprintf(stderr, "Usage: %s [robin_hood|swiss|typed] [num_keys]\n", argv[0]);
+        return 1;
+    }
+    int num_errors = 0;
+    if (argc > 2) {
+        num_errors += _bench(engine, atoi(argv[2]));
+    } else {
+        num_errors += _bench(engine, 200000);
+        num_errors += _bench(engine, 2000000);
+    }
+    return num_errors != 0;
+}
@@ -0,0 +1,63 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../utils/list.h"
+#include "bench.h"
+
+/*
+ * Compares lists with malloc'd nodes against lists with pooled nodes. Each round inserts NUM_ELEMENTS elements at
+ * the end of NUM_LISTS interleaved lists, iterates over them once and removes them all from the front. Interleaving
+ * the lists interleaves their malloc'd nodes in the heap, as in a program that keeps several lists.
+ */
+
+#define NUM_ELEMENTS 1000000
+#define NUM_LISTS 4
+#define NUM_ROUNDS 20
+
+double _run(Pool pool, int num_rounds) {
+    List lists[NUM_LISTS];
+    for (int i = 0; i < NUM_LISTS; i++) {
+        lists[i] = pool != NULL ? list_create_with_pool(pool) : list_create();
+    }
+    uintptr_t sum = 0;
+    double start = bench_now();
+    for (int round = 0; round < num_rounds; round++) {
+        for (uintptr_t i = 0; i < NUM_ELEMENTS; i++) {
+            list_insert_last(lists[i % NUM_LISTS], (void*)(i + 1));
+        }
+        for (int i = 0; i < NUM_LISTS; i++) {
+            list_iterator_start(lists[i]);
+            while (list_iterator_has_next(lists[i])) {
+                sum += (uintptr_t)list_iterator_get_next(lists[i]);
+            }
+        }
+        for (int i = 0; i < NUM_ELEMENTS; i++) {
+            list_remove_first(lists[i % NUM_LISTS]);
+        }
+    }
+    double seconds = bench_now() - start;
+    for (int i = 0; i < NUM_LISTS; i++) {
+        list_destroy(lists[i], NULL);
+    }
+    /* Keeps the iteration from being optimised away. */
+    if (sum == 0) {
+        printf("\n");
+    }
+    return seconds;
+}
+
+int main() {
+    double operations = 2.0 * NUM_ELEMENTS * NUM_ROUNDS;
+    _run(NULL, 1);
+    double malloc_seconds = _run(NULL, NUM_ROUNDS);
+    Pool pool = list_pool_create();
+    _run(pool, 1);
+    double pool_seconds = _run(pool, NUM_ROUNDS);
+    pool_destroy(pool);
+
+    printf("%d lists, %d insert_last + iteration + %d remove_first per round, %d rounds\n", NUM_LISTS, NUM_ELEMENTS,
+           NUM_ELEMENTS, NUM_ROUNDS);
+    printf("malloc nodes:  %.1f Mops/s\n", operations / malloc_seconds / 1e6);
+    printf("pooled nodes:  %.1f Mops/s\n", operations / pool_seconds / 1e6);
+    return 0;
+}
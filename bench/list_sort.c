@@ -0,0 +1,76 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../utils/list.h"
+#include "bench.h"
+
+/*
+ * Sorts a list of NUM_ELEMENTS elements with NUM_KEYS distinct keys with list_sort, and the same list through
+ * list_to_array, qsort and a rebuild, and checks that list_sort is stable. Each element packs its key in the high
+ * 32 bits and its original position in the low 32 bits.
+ */
+
+#define NUM_ELEMENTS 1000000
+#define NUM_KEYS 100000
+
+int _compare_keys(void* element1, void* element2) {
+    uintptr_t key1 = (uintptr_t)element1 >> 32;
+    uintptr_t key2 = (uintptr_t)element2 >> 32;
+    return key1 < key2 ? -1 : key1 > key2;
+}
+
+int _compare_array_keys(const void* element1, const void* element2) {
+    return _compare_keys(*(void**)element1, *(void**)element2);
+}
+
+bool _sorted_and_stable(List list) {
+    void* previous = NULL;
+    list_iterator_start(list);
+    while (list_iterator_has_next(list)) {
+        void* element = list_iterator_get_next(list);
+        if (previous != NULL) {
+            int order = _compare_keys(previous, element);
+            if (order > 0 || (order == 0 && (uint32_t)(uintptr_t)previous > (uint32_t)(uintptr_t)element)) {
+                return false;
+            }
+        }
+        previous = element;
+    }
+    return list_get_last(list) == previous;
+}
+
+int main() {
+    List sorted = list_create();
+    List through_array = list_create();
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (uintptr_t i = 0; i < NUM_ELEMENTS; i++) {
+        void* element = (void*)(((bench_random(&state) % NUM_KEYS) << 32) | i);
+        list_insert_last(sorted, element);
+        list_insert_last(through_array, element);
+    }
+
+    double start = bench_now();
+    list_sort(sorted, _compare_keys);
+    double list_seconds = bench_now() - start;
+
+    start = bench_now();
+    void** array = malloc(sizeof(void*) * NUM_ELEMENTS);
+    list_to_array(through_array, array);
+    qsort(array, NUM_ELEMENTS, sizeof(void*), _compare_array_keys);
+    list_make_empty(through_array, NULL);
+    for (int i = 0; i < NUM_ELEMENTS; i++) {
+        list_insert_last(through_array, array[i]);
+    }
+    double array_seconds = bench_now() - start;
+
+    printf("%d elements, %d keys\n", NUM_ELEMENTS, NUM_KEYS);
+    printf("list_sort:                        %.3f s  sorted and stable: %s\n", list_seconds,
+           _sorted_and_stable(sorted) ? "yes" : "no");
+    printf("list_to_array + qsort + rebuild:  %.3f s  sorted and stable: %s\n", array_seconds,
+           _sorted_and_stable(through_array) ? "yes" : "no");
+    free(array);
+    list_destroy(sorted, NULL);
+    list_destroy(through_array, NULL);
+    return 0;
+}
@@ -1,55 +1,632 @@
 #include "task_list.h"
+#include <fcntl.h>
+#include <libgen.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "../utils/list.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "task_log.h"
+#include "../utils/arena.h"
+#include "../utils/bitmap.h"
+#include "../utils/inverted_index.h"
+#include "../utils/skip_list.h"
+#include "../utils/typed_hash_table.h"
+
+#define INITIAL_CAPACITY 16
+
+#define SNAPSHOT_MAGIC 0x4c544150 /* "PATL" */
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BUFFER_SIZE (1024 * 1024)
+
+/* Maps task ids to their position in the tasks array. */
+DEFINE_TYPED_HASH_TABLE(TaskIndex, task_index, uint64_t, uint32_t, typed_hash_uint64, typed_equal_uint64)
+
+/*
+ * A snapshot is a header, followed by one fixed-size record per task, followed by the
+ * null-terminated descriptions. Loading maps the file and points descriptions into it.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t num_tasks;
+    uint64_t next_id;
+    uint64_t strings_size;
+} SnapshotHeader;
+
+typedef struct {
+    uint64_t id;
+    uint64_t description_offset;
+    uint32_t description_length;
+    uint32_t status;
+} SnapshotRecord;
 
 struct TaskList_ {
-    List tasks;
+    struct Task_* tasks;
+    int num_records;
+    int num_deleted;
+    int capacity;
+    uint64_t next_id;
+    Arena strings;
+    TaskIndex index;
+    Bitmap by_status[NUM_TASK_STATUSES];
+    int status_counts[NUM_TASK_STATUSES];
+    /* Built on first use, since building them costs more than loading a snapshot; NULL until then. */
+    SkipList by_description;
+    InvertedIndex words;
+    char* snapshot;
+    size_t snapshot_size;
+    TaskLog log;
 };
 
+int _compare_descriptions(void* description1, void* description2) {
+    return strcmp((char*)description1, (char*)description2);
+}
+
 TaskList task_list_new() {
     TaskList task_list = malloc(sizeof(struct TaskList_));
-    task_list->tasks = list_create();
+    task_list->num_records = 0;
+    task_list->num_deleted = 0;
+    task_list->capacity = INITIAL_CAPACITY;
+    task_list->tasks = malloc(sizeof(struct Task_) * task_list->capacity);
+    task_list->next_id = 0;
+    task_list->strings = arena_create(0);
+    task_index_init(&task_list->index, INITIAL_CAPACITY);
+    for (int status = 0; status < NUM_TASK_STATUSES; status++) {
+        task_list->by_status[status] = bitmap_create(task_list->capacity);
+        task_list->status_counts[status] = 0;
+    }
+    task_list->by_description = NULL;
+    task_list->words = NULL;
+    task_list->snapshot = NULL;
+    task_list->snapshot_size = 0;
+    task_list->log = NULL;
     return task_list;
 }
 
 void task_list_destroy(TaskList task_list) {
-    list_destroy(task_list->tasks, NULL);
+    if (task_list->log != NULL) {
+        task_log_close(task_list->log);
+    }
+    task_index_destroy(&task_list->index);
+    for (int status = 0; status < NUM_TASK_STATUSES; status++) {
+        bitmap_destroy(task_list->by_status[status]);
+    }
+    if (task_list->by_description != NULL) {
+        skip_list_destroy(task_list->by_description);
+    }
+    if (task_list->words != NULL) {
+        inverted_index_destroy(task_list->words);
+    }
+    free(task_list->tasks);
+    arena_destroy(task_list->strings);
+    if (task_list->snapshot != NULL) {
+        munmap(task_list->snapshot, task_list->snapshot_size);
+    }
     free(task_list);
 }
 
-char* _generate_id(TaskList task_list) {
-    char* id = malloc(sizeof(char) * 10);
-    sprintf(id, "%d", list_size(task_list->tasks));
-    return id;
+void _resize(TaskList task_list, int capacity) {
+    task_list->capacity = capacity;
+    task_list->tasks = realloc(task_list->tasks, sizeof(struct Task_) * capacity);
+    for (int status = 0; status < NUM_TASK_STATUSES; status++) {
+        bitmap_resize(task_list->by_status[status], capacity);
+    }
+}
+
+void _reserve(TaskList task_list, int num_records) {
+    if (num_records > task_list->capacity) {
+        int capacity = task_list->capacity;
+        while (capacity < num_records) {
+            capacity *= 2;
+        }
+        _resize(task_list, capacity);
+    }
+    task_index_reserve(&task_list->index, num_records);
+}
+
+/* Returns false, adding nothing, if the task could not be logged. */
+bool _add_task(TaskList task_list, const char* description, size_t length, uint64_t* id_out) {
+    uint64_t id = task_list->next_id;
+    if (task_list->log != NULL && !task_log_append_add(task_list->log, id, description, length)) {
+        return false;
+    }
+    task_list->next_id++;
+    _reserve(task_list, task_list->num_records + 1);
+    int position = task_list->num_records;
+    Task task = &task_list->tasks[position];
+    task_init(task, id, arena_strndup(task_list->strings, description, length), length);
+    task_list->num_records++;
+    task_index_insert(&task_list->index, id, position);
+    bitmap_set(task_list->by_status[TASK_PENDING], position);
+    task_list->status_counts[TASK_PENDING]++;
+    if (task_list->by_description != NULL) {
+        skip_list_insert(task_list->by_description, task_get_description(task), (void*)(uintptr_t)id);
+    }
+    if (task_list->words != NULL) {
+        inverted_index_add(task_list->words, id, task_get_description(task), length);
+    }
+    if (id_out != NULL) {
+        *id_out = id;
+    }
+    return true;
+}
+
+Task _find_task(TaskList task_list, uint64_t id) {
+    uint32_t* position = task_index_get(&task_list->index, id);
+    if (position == NULL) {
+        return NULL;
+    }
+    return &task_list->tasks[*position];
+}
+
+bool _is_live(uint64_t id, void* context) {
+    return task_index_get(&((TaskList)context)->index, id) != NULL;
+}
+
+SkipList _by_description(TaskList task_list) {
+    if (task_list->by_description == NULL) {
+        task_list->by_description = skip_list_create(_compare_descriptions);
+        for (int i = 0; i < task_list->num_records; i++) {
+            Task task = &task_list->tasks[i];
+            if (!task_is_deleted(task)) {
+                uint64_t id = task_get_id(task);
+                skip_list_insert(task_list->by_description, task_get_description(task), (void*)(uintptr_t)id);
+            }
+        }
+    }
+    return task_list->by_description;
+}
+
+/* Records are in id order, so every id is appended to the end of its words' arrays. */
+InvertedIndex _words(TaskList task_list) {
+    if (task_list->words == NULL) {
+        task_list->words = inverted_index_create(_is_live, task_list);
+        for (int i = 0; i < task_list->num_records; i++) {
+            Task task = &task_list->tasks[i];
+            if (!task_is_deleted(task)) {
+                uint32_t length = task_get_description_length(task);
+                inverted_index_add(task_list->words, task_get_id(task), task_get_description(task), length);
+            }
+        }
+    }
+    return task_list->words;
+}
+
+/* Every status change goes through here so the per-status bitmaps and counters stay in step with the records. */
+void _set_status(TaskList task_list, Task task, TaskStatus status) {
+    int position = task - task_list->tasks;
+    if (!task_is_deleted(task)) {
+        bitmap_clear(task_list->by_status[task_get_status(task)], position);
+        task_list->status_counts[task_get_status(task)]--;
+    }
+    task_set_status(task, status);
+    if (status != TASK_DELETED) {
+        bitmap_set(task_list->by_status[status], position);
+        task_list->status_counts[status]++;
+    }
+}
+
+TaskListResult task_list_add_task(TaskList task_list, char* description, uint64_t* id) {
+    return _add_task(task_list, description, strlen(description), id) ? TASK_LIST_OK : TASK_LIST_LOG_FAILED;
+}
+
+/* Maps a whole file read-only. An empty file maps to NULL with size 0. */
+bool _map_file(const char* path, char** data, size_t* size) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
+        close(fd);
+        return false;
+    }
+    *size = info.st_size;
+    *data = NULL;
+    if (*size > 0) {
+        *data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    return *data != MAP_FAILED;
+}
+
+TaskListResult task_list_import(TaskList task_list, const char* path, long* num_imported) {
+    *num_imported = 0;
+    char* data;
+    size_t size;
+    if (!_map_file(path, &data, &size)) {
+        return TASK_LIST_NOT_FOUND;
+    }
+    if (size == 0) {
+        return TASK_LIST_OK;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    char* end = data + size;
+
+    /* Count the lines first so the tasks array and the index are sized once. */
+    int num_lines = 1;
+    for (char* p = data; (p = memchr(p, '\n', end - p)) != NULL; p++) {
+        num_lines++;
+    }
+    _reserve(task_list, task_list->num_records + num_lines);
+
+    char* line = data;
+    while (line < end) {
+        char* newline = memchr(line, '\n', end - line);
+        char* line_end = newline != NULL ? newline : end;
+        size_t length = line_end - line;
+        if (length > 0 && line[length - 1] == '\r') {
+            length--;
+        }
+        if (length > 0) {
+            if (!_add_task(task_list, line, length, NULL)) {
+                munmap(data, size);
+                return TASK_LIST_LOG_FAILED;
+            }
+            (*num_imported)++;
+        }
+        line = line_end + 1;
+    }
+    munmap(data, size);
+    return TASK_LIST_OK;
+}
+
+void _sync_directory(const char* path) {
+    char* copy = strdup(path);
+    int fd = open(dirname(copy), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    free(copy);
 }
 
-char* task_list_add_task(TaskList task_list, char* description) {
-    char* id = _generate_id(task_list);
-    Task task = task_new(id, description);
-    free(id);
-    list_insert_last(task_list->tasks, task);
-    return task_get_id(task);
+bool task_list_save(TaskList task_list, const char* path) {
+    size_t path_length = strlen(path);
+    char* temp_path = malloc(path_length + sizeof(".tmp"));
+    memcpy(temp_path, path, path_length);
+    memcpy(temp_path + path_length, ".tmp", sizeof(".tmp"));
+    FILE* file = fopen(temp_path, "wb");
+    if (file == NULL) {
+        free(temp_path);
+        return false;
+    }
+    setvbuf(file, NULL, _IOFBF, SNAPSHOT_BUFFER_SIZE);
+
+    SnapshotHeader header = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, task_list->num_records - task_list->num_deleted, task_list->next_id, 0};
+    for (int i = 0; i < task_list->num_records; i++) {
+        if (!task_is_deleted(&task_list->tasks[i])) {
+            header.strings_size += task_get_description_length(&task_list->tasks[i]) + 1;
+        }
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    uint64_t offset = 0;
+    for (int i = 0; ok && i < task_list->num_records; i++) {
+        Task task = &task_list->tasks[i];
+        if (task_is_deleted(task)) {
+            continue;
+        }
+        SnapshotRecord record = {task_get_id(task), offset, task_get_description_length(task), task_get_status(task)};
+        ok = fwrite(&record, sizeof(record), 1, file) == 1;
+        offset += record.description_length + 1;
+    }
+    for (int i = 0; ok && i < task_list->num_records; i++) {
+        Task task = &task_list->tasks[i];
+        if (task_is_deleted(task)) {
+            continue;
+        }
+        size_t size = task_get_description_length(task) + 1;
+        ok = fwrite(task_get_description(task), 1, size, file) == size;
+    }
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = fclose(file) == 0 && ok;
+    ok = ok && rename(temp_path, path) == 0;
+    if (ok) {
+        _sync_directory(path);
+    } else {
+        unlink(temp_path);
+    }
+    free(temp_path);
+    return ok;
+}
+
+bool _valid_snapshot(char* data, size_t size) {
+    if (size < sizeof(SnapshotHeader)) {
+        return false;
+    }
+    SnapshotHeader* header = (SnapshotHeader*)data;
+    size_t max_tasks = (size - sizeof(SnapshotHeader)) / sizeof(SnapshotRecord);
+    return header->magic == SNAPSHOT_MAGIC && header->version == SNAPSHOT_VERSION && header->num_tasks <= max_tasks &&
+           header->num_tasks <= INT32_MAX &&
+           sizeof(SnapshotHeader) + header->num_tasks * sizeof(SnapshotRecord) + header->strings_size == size;
+}
+
+TaskList task_list_load(const char* path) {
+    char* data;
+    size_t size;
+    if (!_map_file(path, &data, &size)) {
+        return NULL;
+    }
+    if (!_valid_snapshot(data, size)) {
+        if (data != NULL) {
+            munmap(data, size);
+        }
+        return NULL;
+    }
+    SnapshotHeader* header = (SnapshotHeader*)data;
+    SnapshotRecord* records = (SnapshotRecord*)(data + sizeof(SnapshotHeader));
+    char* strings = (char*)(records + header->num_tasks);
+
+    TaskList task_list = task_list_new();
+    task_list->snapshot = data;
+    task_list->snapshot_size = size;
+    _reserve(task_list, header->num_tasks);
+    for (int i = 0; i < (int)header->num_tasks; i++) {
+        SnapshotRecord* record = &records[i];
+        uint64_t offset = record->description_offset;
+        bool valid = offset < header->strings_size && record->description_length < header->strings_size - offset &&
+                     strings[offset + record->description_length] == '\0' && record->status <= TASK_CANCELLED &&
+                     record->id < header->next_id && (i == 0 || record->id > records[i - 1].id);
+        if (!valid) {
+            task_list_destroy(task_list);
+            return NULL;
+        }
+        Task task = &task_list->tasks[i];
+        task_init(task, record->id, strings + record->description_offset, record->description_length);
+        task_set_status(task, record->status);
+        task_index_insert(&task_list->index, record->id, i);
+        bitmap_set(task_list->by_status[record->status], i);
+        task_list->status_counts[record->status]++;
+        task_list->num_records++;
+    }
+    task_list->next_id = header->next_id;
+    return task_list;
+}
+
+/*
+ * Records already covered by the snapshot the list was loaded from are skipped, so replay is idempotent.
+ * Records with an unknown operation or status are rejected, like invalid snapshot records.
+ */
+bool _apply_log_record(TaskLogRecord* record, void* context) {
+    TaskList task_list = (TaskList)context;
+    if (record->operation == TASK_LOG_ADD) {
+        if (record->id >= task_list->next_id) {
+            task_list->next_id = record->id;
+            _add_task(task_list, record->description, record->description_length, NULL);
+        }
+    } else if (record->operation == TASK_LOG_STATUS) {
+        if (record->status > TASK_CANCELLED) {
+            return false;
+        }
+        Task task = _find_task(task_list, record->id);
+        if (task != NULL) {
+            _set_status(task_list, task, record->status);
+        }
+    } else if (record->operation == TASK_LOG_DELETE) {
+        task_list_delete_task(task_list, record->id);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool task_list_open_log(TaskList task_list, const char* path) {
+    task_list->log = task_log_open(path, _apply_log_record, task_list);
+    return task_list->log != NULL;
+}
+
+bool task_list_sync(TaskList task_list) {
+    return task_list->log == NULL || task_log_sync(task_list->log);
+}
+
+/*
+ * The snapshot holds every change applied so far, so the log can be emptied even if its last group failed to
+ * commit; a successful checkpoint is how a failed log is recovered.
+ */
+bool task_list_checkpoint(TaskList task_list, const char* path) {
+    task_list_sync(task_list);
+    if (!task_list_save(task_list, path)) {
+        return false;
+    }
+    return task_list->log == NULL || task_log_truncate(task_list->log);
 }
 
-bool equal_tasks(void* e1, void* e2) {
-    Task t1 = (Task)e1;
-    Task t2 = (Task)e2;
-    return task_get_id(t1) == task_get_id(t2);
+TaskListResult task_list_complete_task(TaskList task_list, uint64_t id) {
+    Task task = _find_task(task_list, id);
+    if (task == NULL) {
+        return TASK_LIST_NOT_FOUND;
+    }
+    if (task_list->log != NULL && !task_log_append_status(task_list->log, id, TASK_COMPLETED)) {
+        return TASK_LIST_LOG_FAILED;
+    }
+    _set_status(task_list, task, TASK_COMPLETED);
+    return TASK_LIST_OK;
 }
 
-void task_list_complete_task(TaskList task_list, char* id) {
-    Task temp_task = task_new(id, NULL);
-    int pos = list_find(task_list->tasks, equal_tasks, temp_task);
-    Task task = list_get(task_list->tasks, pos);
-    task_set_completed(task);
+bool _in_snapshot(TaskList task_list, const char* string) {
+    return task_list->snapshot != NULL && string >= task_list->snapshot &&
+           string < task_list->snapshot + task_list->snapshot_size;
+}
+
+/*
+ * Drops the tombstones left by deletions, keeping the remaining tasks in id order, and moves
+ * the live descriptions into a fresh arena so the memory of deleted ones is released too.
+ * The status bitmaps refer to positions, so they are rebuilt; the description index refers to
+ * the moved descriptions, so it is dropped and rebuilt on its next use.
+ * Runs once tombstones are the majority of the records, so its cost is amortised over them.
+ */
+void _compact(TaskList task_list) {
+    Arena strings = arena_create(0);
+    for (int status = 0; status < NUM_TASK_STATUSES; status++) {
+        bitmap_clear_all(task_list->by_status[status]);
+    }
+    if (task_list->by_description != NULL) {
+        skip_list_destroy(task_list->by_description);
+        task_list->by_description = NULL;
+    }
+    int num_live = 0;
+    for (int i = 0; i < task_list->num_records; i++) {
+        Task task = &task_list->tasks[i];
+        if (task_is_deleted(task)) {
+            continue;
+        }
+        char* description = task_get_description(task);
+        uint32_t length = task_get_description_length(task);
+        if (!_in_snapshot(task_list, description)) {
+            description = arena_strndup(strings, description, length);
+        }
+        uint64_t id = task_get_id(task);
+        TaskStatus status = task_get_status(task);
+        Task moved = &task_list->tasks[num_live];
+        task_init(moved, id, description, length);
+        task_set_status(moved, status);
+        if (num_live != i) {
+            *task_index_get(&task_list->index, id) = num_live;
+        }
+        bitmap_set(task_list->by_status[status], num_live);
+        num_live++;
+    }
+    arena_destroy(task_list->strings);
+    task_list->strings = strings;
+    task_list->num_records = num_live;
+    task_list->num_deleted = 0;
+    int capacity = task_list->capacity;
+    while (capacity > INITIAL_CAPACITY && num_live < capacity / 4) {
+        capacity /= 2;
+    }
+    if (capacity != task_list->capacity) {
+        _resize(task_list, capacity);
+    }
+}
+
+TaskListResult task_list_delete_task(TaskList task_list, uint64_t id) {
+    if (task_index_get(&task_list->index, id) == NULL) {
+        return TASK_LIST_NOT_FOUND;
+    }
+    if (task_list->log != NULL && !task_log_append_delete(task_list->log, id)) {
+        return TASK_LIST_LOG_FAILED;
+    }
+    uint32_t position;
+    task_index_remove(&task_list->index, id, &position);
+    Task task = &task_list->tasks[position];
+    if (task_list->by_description != NULL) {
+        skip_list_remove(task_list->by_description, task_get_description(task), (void*)(uintptr_t)id);
+    }
+    if (task_list->words != NULL) {
+        inverted_index_remove(task_list->words, id, task_get_description(task), task_get_description_length(task));
+    }
+    _set_status(task_list, task, TASK_DELETED);
+    task_list->num_deleted++;
+    if (task_list->num_deleted > task_list->num_records / 2) {
+        _compact(task_list);
+    }
+    return TASK_LIST_OK;
 }
 
 int task_list_get_num_tasks(TaskList task_list) {
-    return list_size(task_list->tasks);
+    return task_list->num_records - task_list->num_deleted;
+}
+
+int task_list_count_status(TaskList task_list, TaskStatus status) {
+    return task_list->status_counts[status];
+}
+
+int _lower_bound_id(TaskList task_list, uint64_t id) {
+    int low = 0;
+    int high = task_list->num_records;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (task_get_id(&task_list->tasks[middle]) < id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+bool _matches(const TaskFilter* filter, Task task) {
+    if (filter->status != TASK_FILTER_ANY_STATUS && task_get_status(task) != (TaskStatus)filter->status) {
+        return false;
+    }
+    uint64_t id = task_get_id(task);
+    if (id < filter->min_id || id > filter->max_id) {
+        return false;
+    }
+    return filter->substring == NULL || strstr(task_get_description(task), filter->substring) != NULL;
+}
+
+/*
+ * Records are kept in id order, so an id range is a run of positions: the walk starts at the first id in range and
+ * stops at the first one past it. With a status bitmap only the positions set in it are visited.
+ */
+bool _visit_positions(TaskList task_list, Bitmap positions, const TaskFilter* filter, bool (*visit)(Task task, void* context), void* context) {
+    long i = _lower_bound_id(task_list, filter->min_id);
+    if (positions != NULL) {
+        i = bitmap_next_set(positions, i);
+    }
+    while (i >= 0 && i < task_list->num_records) {
+        Task task = &task_list->tasks[i];
+        if (task_get_id(task) > filter->max_id) {
+            break;
+        }
+        if (!task_is_deleted(task) && _matches(filter, task) && !visit(task, context)) {
+            return false;
+        }
+        i = positions != NULL ? bitmap_next_set(positions, i + 1) : i + 1;
+    }
+    return true;
+}
+
+void task_list_visit(TaskList task_list, TaskOrder order, const TaskFilter* filter, bool (*visit)(Task task, void* context), void* context) {
+    TaskFilter everything = {TASK_FILTER_ANY_STATUS, 0, UINT64_MAX, NULL};
+    if (filter == NULL) {
+        filter = &everything;
+    }
+    if (order == TASK_ORDER_DESCRIPTION) {
+        SkipListNode node = skip_list_first(_by_description(task_list));
+        for (; node != NULL; node = skip_list_next(node)) {
+            Task task = _find_task(task_list, (uintptr_t)skip_list_value(node));
+            if (_matches(filter, task) && !visit(task, context)) {
+                return;
+            }
+        }
+    } else if (filter->status != TASK_FILTER_ANY_STATUS) {
+        _visit_positions(task_list, task_list->by_status[filter->status], filter, visit, context);
+    } else if (order == TASK_ORDER_STATUS) {
+        for (int status = 0; status < NUM_TASK_STATUSES; status++) {
+            if (!_visit_positions(task_list, task_list->by_status[status], filter, visit, context)) {
+                return;
+            }
+        }
+    } else {
+        _visit_positions(task_list, NULL, filter, visit, context);
+    }
+}
+
+void task_list_visit_prefix(TaskList task_list, const char* prefix, bool (*visit)(Task task, void* context), void* context) {
+    /* Descriptions sharing a prefix are contiguous in the description order, starting at the prefix itself. */
+    size_t length = strlen(prefix);
+    SkipListNode node = skip_list_lower_bound(_by_description(task_list), (void*)prefix);
+    for (; node != NULL; node = skip_list_next(node)) {
+        if (strncmp(skip_list_key(node), prefix, length) != 0) {
+            return;
+        }
+        if (!visit(_find_task(task_list, (uintptr_t)skip_list_value(node)), context)) {
+            return;
+        }
+    }
 }
 
-Task* task_list_get_tasks(TaskList task_list) {
-    return task_list->tasks;
+void task_list_search(TaskList task_list, const char* query, bool (*visit)(Task task, void* context), void* context) {
+    const uint64_t* ids;
+    size_t num_ids = inverted_index_search(_words(task_list), query, &ids);
+    for (size_t i = 0; i < num_ids; i++) {
+        if (!visit(_find_task(task_list, ids[i]), context)) {
+            return;
+        }
+    }
 }
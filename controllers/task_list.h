@@ -1,20 +1,69 @@
 #ifndef TASK_LIST_H
 #define TASK_LIST_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "../models/tasks.h"
 
 typedef struct TaskList_* TaskList;
 
+typedef enum {
+    TASK_ORDER_ID,
+    TASK_ORDER_STATUS,
+    TASK_ORDER_DESCRIPTION
+} TaskOrder;
+
+/* A change that cannot be written to the log is not applied. */
+typedef enum {
+    TASK_LIST_OK,
+    TASK_LIST_NOT_FOUND,
+    TASK_LIST_LOG_FAILED
+} TaskListResult;
+
+#define TASK_FILTER_ANY_STATUS -1
+
+/* Restricts a listing to one status (or TASK_FILTER_ANY_STATUS), an inclusive id range and, unless NULL, descriptions containing a substring. */
+typedef struct {
+    int status;
+    uint64_t min_id;
+    uint64_t max_id;
+    const char* substring;
+} TaskFilter;
+
 TaskList task_list_new();
 
 void task_list_destroy(TaskList task_list);
 
-char* task_list_add_task(TaskList task_list, char* description);
+TaskListResult task_list_add_task(TaskList task_list, char* description, uint64_t* id);
+
+/*
+ * Adds one task per non-empty line of a file, counting them in num_imported. Returns TASK_LIST_NOT_FOUND if the file
+ * cannot be read; on TASK_LIST_LOG_FAILED the tasks counted before the failure stay imported.
+ */
+TaskListResult task_list_import(TaskList task_list, const char* path, long* num_imported);
+
+bool task_list_save(TaskList task_list, const char* path);
+
+TaskList task_list_load(const char* path);
 
-void task_list_complete_task(TaskList task_list, char* id);
+bool task_list_open_log(TaskList task_list, const char* path);
+
+bool task_list_sync(TaskList task_list);
+
+bool task_list_checkpoint(TaskList task_list, const char* path);
+
+TaskListResult task_list_complete_task(TaskList task_list, uint64_t id);
+
+TaskListResult task_list_delete_task(TaskList task_list, uint64_t id);
 
 int task_list_get_num_tasks(TaskList task_list);
 
-Task* task_list_get_tasks(TaskList task_list);
+int task_list_count_status(TaskList task_list, TaskStatus status);
+
+void task_list_visit(TaskList task_list, TaskOrder order, const TaskFilter* filter, bool (*visit)(Task task, void* context), void* context);
+
+void task_list_visit_prefix(TaskList task_list, const char* prefix, bool (*visit)(Task task, void* context), void* context);
+
+void task_list_search(TaskList task_list, const char* query, bool (*visit)(Task task, void* context), void* context);
 
 #endif
@@ -0,0 +1,204 @@
+#include "task_log.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOG_BUFFER_SIZE (256 * 1024)
+#define GROUP_COMMIT_DELAY_NS (5 * 1000 * 1000)
+
+/*
+ * The log is a sequence of records, each a fixed-size header followed by the description bytes.
+ * Records are buffered and committed in groups: the first append after GROUP_COMMIT_DELAY_NS
+ * since the oldest uncommitted record writes the buffer out and issues a single fsync.
+ *
+ * A failed write or fsync may leave a torn record, and replay stops at the first one, so nothing
+ * appended after it would be recovered. The log therefore refuses further appends until it is
+ * truncated by a checkpoint.
+ */
+typedef struct {
+    uint64_t id;
+    uint32_t description_length;
+    uint32_t checksum;
+    uint8_t operation;
+    uint8_t status;
+    uint8_t reserved[6];
+} LogRecordHeader;
+
+struct TaskLog_ {
+    int fd;
+    bool pending;
+    bool failed;
+    struct timespec pending_since;
+    size_t used;
+    char buffer[LOG_BUFFER_SIZE];
+};
+
+/* FNV-1a, enough to detect a record torn by a crash in the middle of a write. */
+uint32_t _checksum(const LogRecordHeader* header, const char* description) {
+    LogRecordHeader copy = *header;
+    copy.checksum = 0;
+    uint32_t hash = 2166136261u;
+    const unsigned char* bytes = (const unsigned char*)&copy;
+    for (size_t i = 0; i < sizeof(copy); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    bytes = (const unsigned char*)description;
+    for (size_t i = 0; i < header->description_length; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* Returns the length of the valid prefix of the log, or -1 if it cannot be read or apply rejects a record. */
+long _replay(int fd, bool (*apply)(TaskLogRecord* record, void* context), void* context) {
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
+        return -1;
+    }
+    if (info.st_size == 0) {
+        return 0;
+    }
+    char* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        return -1;
+    }
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+    size_t offset = 0;
+    while (info.st_size - offset >= sizeof(LogRecordHeader)) {
+        LogRecordHeader header;
+        memcpy(&header, data + offset, sizeof(header));
+        const char* description = data + offset + sizeof(header);
+        if (header.description_length > info.st_size - offset - sizeof(header) ||
+            header.checksum != _checksum(&header, description)) {
+            break;
+        }
+        TaskLogRecord record = {header.operation, header.id, header.status, description, header.description_length};
+        if (!apply(&record, context)) {
+            munmap(data, info.st_size);
+            return -1;
+        }
+        offset += sizeof(header) + header.description_length;
+    }
+    munmap(data, info.st_size);
+    return offset;
+}
+
+TaskLog task_log_open(const char* path, bool (*apply)(TaskLogRecord* record, void* context), void* context) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+    /* Drop a record torn by a crash, so new records are not appended after garbage. */
+    long valid_length = _replay(fd, apply, context);
+    if (valid_length < 0 || ftruncate(fd, valid_length) < 0 || lseek(fd, valid_length, SEEK_SET) < 0) {
+        close(fd);
+        return NULL;
+    }
+    TaskLog log = malloc(sizeof(struct TaskLog_));
+    log->fd = fd;
+    log->pending = false;
+    log->failed = false;
+    log->used = 0;
+    return log;
+}
+
+void task_log_close(TaskLog log) {
+    task_log_sync(log);
+    close(log->fd);
+    free(log);
+}
+
+bool _write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+void _flush_log(TaskLog log) {
+    if (!_write_all(log->fd, log->buffer, log->used)) {
+        log->failed = true;
+    }
+    log->used = 0;
+}
+
+/* Returns false if the pending records could not be committed. */
+bool task_log_sync(TaskLog log) {
+    if (!log->pending) {
+        return true;
+    }
+    _flush_log(log);
+    if (fdatasync(log->fd) != 0) {
+        log->failed = true;
+    }
+    log->pending = false;
+    return !log->failed;
+}
+
+bool task_log_truncate(TaskLog log) {
+    log->used = 0;
+    log->pending = false;
+    log->failed = ftruncate(log->fd, 0) != 0 || lseek(log->fd, 0, SEEK_SET) != 0 || fdatasync(log->fd) != 0;
+    return !log->failed;
+}
+
+/* Returns false, without appending, once the log has failed. */
+bool _append_record(TaskLog log, LogRecordHeader* header, const char* description) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (log->pending) {
+        long long elapsed = (now.tv_sec - log->pending_since.tv_sec) * 1000000000LL + (now.tv_nsec - log->pending_since.tv_nsec);
+        if (elapsed >= GROUP_COMMIT_DELAY_NS) {
+            task_log_sync(log);
+        }
+    }
+    if (log->failed) {
+        return false;
+    }
+    if (!log->pending) {
+        log->pending = true;
+        log->pending_since = now;
+    }
+
+    header->checksum = _checksum(header, description);
+    size_t size = sizeof(*header) + header->description_length;
+    if (log->used + size > LOG_BUFFER_SIZE) {
+        _flush_log(log);
+    }
+    if (log->failed) {
+        return false;
+    }
+    if (size > LOG_BUFFER_SIZE) {
+        log->failed = !_write_all(log->fd, (const char*)header, sizeof(*header)) ||
+                      !_write_all(log->fd, description, header->description_length);
+        return !log->failed;
+    }
+    memcpy(log->buffer + log->used, header, sizeof(*header));
+    memcpy(log->buffer + log->used + sizeof(*header), description, header->description_length);
+    log->used += size;
+    return true;
+}
+
+bool task_log_append_add(TaskLog log, uint64_t id, const char* description, uint32_t description_length) {
+    LogRecordHeader header = {id, description_length, 0, TASK_LOG_ADD, TASK_PENDING};
+    return _append_record(log, &header, description);
+}
+
+bool task_log_append_status(TaskLog log, uint64_t id, TaskStatus status) {
+    LogRecordHeader header = {id, 0, 0, TASK_LOG_STATUS, status};
+    return _append_record(log, &header, "");
+}
+
+bool task_log_append_delete(TaskLog log, uint64_t id) {
+    LogRecordHeader header = {id, 0, 0, TASK_LOG_DELETE, TASK_DELETED};
+    return _append_record(log, &header, "");
+}
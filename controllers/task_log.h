@@ -0,0 +1,39 @@
+#ifndef TASK_LOG_H
+#define TASK_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "../models/tasks.h"
+
+typedef struct TaskLog_* TaskLog;
+
+typedef enum {
+    TASK_LOG_ADD = 1,
+    TASK_LOG_STATUS = 2,
+    TASK_LOG_DELETE = 3
+} TaskLogOperation;
+
+typedef struct {
+    TaskLogOperation operation;
+    uint64_t id;
+    TaskStatus status;
+    const char* description;
+    uint32_t description_length;
+} TaskLogRecord;
+
+/* Replays the records already in the log through apply, then opens it for appending; NULL if apply rejects a record. */
+TaskLog task_log_open(const char* path, bool (*apply)(TaskLogRecord* record, void* context), void* context);
+
+void task_log_close(TaskLog log);
+
+bool task_log_append_add(TaskLog log, uint64_t id, const char* description, uint32_t description_length);
+
+bool task_log_append_status(TaskLog log, uint64_t id, TaskStatus status);
+
+bool task_log_append_delete(TaskLog log, uint64_t id);
+
+bool task_log_sync(TaskLog log);
+
+bool task_log_truncate(TaskLog log);
+
+#endif
@@ -1,6 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "controllers/task_list.h"
 #include "views/cli.h"
 
-int main() {
-    run_cli();
+int main(int argc, char* argv[]) {
+    char* snapshot_path = NULL;
+    char* log_path = NULL;
+    char** import_paths = malloc(sizeof(char*) * argc);
+    int num_imports = 0;
+    int option;
+    while ((option = getopt(argc, argv, "s:l:i:")) != -1) {
+        switch (option) {
+            case 's':
+                snapshot_path = optarg;
+                break;
+            case 'l':
+                log_path = optarg;
+                break;
+            case 'i':
+                import_paths[num_imports++] = optarg;
+                break;
+            default:
+                fprintf(stderr, "Utilização: %s [-s snapshot] [-l registo] [-i ficheiro]\n", argv[0]);
+                free(import_paths);
+                return 1;
+        }
+    }
+
+    TaskList task_list;
+    if (snapshot_path != NULL && access(snapshot_path, F_OK) == 0) {
+        task_list = task_list_load(snapshot_path);
+        if (task_list == NULL) {
+            fprintf(stderr, "Não foi possível abrir %s.\n", snapshot_path);
+            free(import_paths);
+            return 1;
+        }
+    } else {
+        task_list = task_list_new();
+    }
+    if (log_path != NULL && !task_list_open_log(task_list, log_path)) {
+        fprintf(stderr, "Não foi possível abrir %s.\n", log_path);
+        task_list_destroy(task_list);
+        free(import_paths);
+        return 1;
+    }
+    for (int i = 0; i < num_imports; i++) {
+        long num_imported;
+        TaskListResult result = task_list_import(task_list, import_paths[i], &num_imported);
+        if (result != TASK_LIST_OK) {
+            if (result == TASK_LIST_NOT_FOUND) {
+                fprintf(stderr, "Não foi possível importar %s.\n", import_paths[i]);
+            } else {
+                fprintf(stderr, "Não foi possível gravar o registo; %ld tarefas importadas de %s.\n", num_imported, import_paths[i]);
+            }
+            task_list_destroy(task_list);
+            free(import_paths);
+            return 1;
+        }
+    }
+    free(import_paths);
+
+    run_cli(task_list, snapshot_path);
+    task_list_destroy(task_list);
     return 0;
-}
\ No newline at end of file
+}
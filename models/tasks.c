@@ -1,29 +1,13 @@
 #include "tasks.h"
-#include <stdlib.h>
-#include <string.h>
 
-struct Task_ {
-    char* id;
-    char* description;
-    char* status;
-};
-
-Task task_new(char* id, char* description) {
-    Task task = malloc(sizeof(struct Task_));
-    task->id = strdup(id);
-    task->description = strdup(description);
-    task->status = strdup("Por completar");
-    return task;
-}
-
-void task_destroy(Task task) {
-    free(task->id);
-    free(task->description);
-    free(task->status);
-    free(task);
+void task_init(Task task, uint64_t id, char* description, uint32_t description_length) {
+    task->id = id;
+    task->description = description;
+    task->description_length = description_length;
+    task->status = TASK_PENDING;
 }
 
-char* task_get_id(Task task) {
+uint64_t task_get_id(Task task) {
     return task->id;
 }
 
@@ -31,11 +15,18 @@ char* task_get_description(Task task) {
     return task->description;
 }
 
-char* task_get_status(Task task) {
+uint32_t task_get_description_length(Task task) {
+    return task->description_length;
+}
+
+TaskStatus task_get_status(Task task) {
     return task->status;
 }
 
-void task_set_completed(Task task) {
-    free(task->status);
-    task->status = strdup("Completa");
+bool task_is_deleted(Task task) {
+    return task->status == TASK_DELETED;
+}
+
+void task_set_status(Task task, TaskStatus status) {
+    task->status = status;
 }
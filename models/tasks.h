@@ -1,18 +1,41 @@
 #ifndef TASKS_H
 #define TASKS_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    TASK_PENDING,
+    TASK_IN_PROGRESS,
+    TASK_COMPLETED,
+    TASK_CANCELLED,
+    TASK_DELETED /* Tombstone left in storage until the task list compacts it away. */
+} TaskStatus;
+
+/* Number of statuses a live task can have. */
+#define NUM_TASK_STATUSES TASK_DELETED
+
 typedef struct Task_* Task;
 
-Task task_new(char* id, char* description);
+struct Task_ {
+    uint64_t id;
+    char* description;
+    uint32_t description_length;
+    TaskStatus status;
+};
 
-void task_destroy(Task task);
+void task_init(Task task, uint64_t id, char* description, uint32_t description_length);
 
-char* task_get_id(Task task);
+uint64_t task_get_id(Task task);
 
 char* task_get_description(Task task);
 
-char* task_get_status(Task task);
+uint32_t task_get_description_length(Task task);
+
+TaskStatus task_get_status(Task task);
+
+bool task_is_deleted(Task task);
 
-void task_set_completed(Task task);
+void task_set_status(Task task, TaskStatus status);
 
 #endif
@@ -0,0 +1,82 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+typedef struct Block_* Block;
+struct Block_ {
+    Block next;
+    size_t capacity;
+    size_t used;
+    char data[];
+};
+
+struct Arena_ {
+    Block current;
+    size_t block_size;
+};
+
+Block _create_block(size_t capacity) {
+    Block block = malloc(sizeof(struct Block_) + capacity);
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+    return block;
+}
+
+Arena arena_create(size_t block_size) {
+    Arena arena = malloc(sizeof(struct Arena_));
+    if (block_size == 0) {
+        arena->block_size = ARENA_DEFAULT_BLOCK_SIZE;
+    } else {
+        arena->block_size = block_size;
+    }
+    arena->current = _create_block(arena->block_size);
+    return arena;
+}
+
+void arena_destroy(Arena arena) {
+    Block block = arena->current;
+    while (block != NULL) {
+        Block next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+void* _arena_bump(Arena arena, size_t size, size_t alignment) {
+    Block block = arena->current;
+    size_t start = (block->used + alignment - 1) & ~(alignment - 1);
+    if (start + size > block->capacity) {
+        if (size > arena->block_size / 4) {
+            /* Large allocations get their own block, behind the current one, so it keeps being filled. */
+            Block large = _create_block(size);
+            large->used = size;
+            large->next = block->next;
+            block->next = large;
+            return large->data;
+        }
+        block = _create_block(arena->block_size);
+        block->next = arena->current;
+        arena->current = block;
+        start = 0;
+    }
+    block->used = start + size;
+    return block->data + start;
+}
+
+void* arena_alloc(Arena arena, size_t size) {
+    return _arena_bump(arena, size, sizeof(void*));
+}
+
+char* arena_strdup(Arena arena, const char* string) {
+    return arena_strndup(arena, string, strlen(string));
+}
+
+char* arena_strndup(Arena arena, const char* string, size_t length) {
+    char* copy = _arena_bump(arena, length + 1, 1);
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    return copy;
+}
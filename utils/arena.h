@@ -0,0 +1,61 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+/**
+ * @brief An arena is a bump allocator that releases all its allocations at once.
+ *
+ * Memory is carved out of large blocks, so allocating is a pointer increment and
+ * destroying the arena frees one block per block_size bytes allocated.
+ */
+typedef struct Arena_* Arena;
+
+/**
+ * @brief Creates a new arena.
+ *
+ * @param block_size The size of each block, or 0 for ARENA_DEFAULT_BLOCK_SIZE.
+ * @return Arena The new arena.
+ */
+Arena arena_create(size_t block_size);
+
+/**
+ * @brief Destroys an arena.
+ *
+ * Frees all memory allocated from the arena.
+ *
+ * @param arena The arena to destroy.
+ */
+void arena_destroy(Arena arena);
+
+/**
+ * @brief Allocates memory from the arena, aligned for any pointer-sized type.
+ *
+ * @param arena The arena.
+ * @param size The number of bytes to allocate.
+ * @return void* The allocated memory.
+ */
+void* arena_alloc(Arena arena, size_t size);
+
+/**
+ * @brief Copies a string into the arena.
+ *
+ * @param arena The arena.
+ * @param string The string to copy.
+ * @return char* The copy of the string.
+ */
+char* arena_strdup(Arena arena, const char* string);
+
+/**
+ * @brief Copies the first length bytes of a string into the arena, adding a terminating null byte.
+ *
+ * @param arena The arena.
+ * @param string The string to copy.
+ * @param length The number of bytes to copy.
+ * @return char* The copy of the string.
+ */
+char* arena_strndup(Arena arena, const char* string, size_t length);
+
+#endif
@@ -0,0 +1,76 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitmap.h"
+
+#define WORD_BITS 64
+
+struct Bitmap_ {
+    uint64_t* words;
+    size_t num_words;
+    size_t num_bits;
+};
+
+size_t _num_words(size_t num_bits) {
+    return (num_bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+Bitmap bitmap_create(size_t num_bits) {
+    Bitmap bitmap = malloc(sizeof(struct Bitmap_));
+    bitmap->num_bits = num_bits;
+    bitmap->num_words = _num_words(num_bits);
+    bitmap->words = calloc(bitmap->num_words > 0 ? bitmap->num_words : 1, sizeof(uint64_t));
+    return bitmap;
+}
+
+void bitmap_destroy(Bitmap bitmap) {
+    free(bitmap->words);
+    free(bitmap);
+}
+
+void bitmap_resize(Bitmap bitmap, size_t num_bits) {
+    size_t num_words = _num_words(num_bits);
+    if (num_words != bitmap->num_words) {
+        bitmap->words = realloc(bitmap->words, sizeof(uint64_t) * (num_words > 0 ? num_words : 1));
+        if (num_words > bitmap->num_words) {
+            memset(bitmap->words + bitmap->num_words, 0, sizeof(uint64_t) * (num_words - bitmap->num_words));
+        }
+        bitmap->num_words = num_words;
+    }
+    if (num_bits < bitmap->num_bits && num_bits % WORD_BITS != 0) {
+        bitmap->words[num_words - 1] &= (UINT64_C(1) << (num_bits % WORD_BITS)) - 1;
+    }
+    bitmap->num_bits = num_bits;
+}
+
+void bitmap_set(Bitmap bitmap, size_t bit) {
+    bitmap->words[bit / WORD_BITS] |= UINT64_C(1) << (bit % WORD_BITS);
+}
+
+void bitmap_clear(Bitmap bitmap, size_t bit) {
+    bitmap->words[bit / WORD_BITS] &= ~(UINT64_C(1) << (bit % WORD_BITS));
+}
+
+bool bitmap_test(Bitmap bitmap, size_t bit) {
+    return (bitmap->words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+}
+
+void bitmap_clear_all(Bitmap bitmap) {
+    memset(bitmap->words, 0, sizeof(uint64_t) * bitmap->num_words);
+}
+
+long bitmap_next_set(Bitmap bitmap, size_t from) {
+    if (from >= bitmap->num_bits) {
+        return -1;
+    }
+    size_t word = from / WORD_BITS;
+    uint64_t bits = bitmap->words[word] & (~UINT64_C(0) << (from % WORD_BITS));
+    while (bits == 0) {
+        if (++word == bitmap->num_words) {
+            return -1;
+        }
+        bits = bitmap->words[word];
+    }
+    return word * WORD_BITS + __builtin_ctzll(bits);
+}
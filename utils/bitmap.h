@@ -0,0 +1,78 @@
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief A bitmap is a growable set of small non-negative integers, one bit each.
+ */
+typedef struct Bitmap_* Bitmap;
+
+/**
+ * @brief Creates a new bitmap with all bits clear.
+ *
+ * @param num_bits The number of bits.
+ * @return Bitmap The new bitmap.
+ */
+Bitmap bitmap_create(size_t num_bits);
+
+/**
+ * @brief Destroys a bitmap.
+ *
+ * @param bitmap The bitmap to destroy.
+ */
+void bitmap_destroy(Bitmap bitmap);
+
+/**
+ * @brief Changes the number of bits. Bits added are clear.
+ *
+ * @param bitmap The bitmap.
+ * @param num_bits The new number of bits.
+ */
+void bitmap_resize(Bitmap bitmap, size_t num_bits);
+
+/**
+ * @brief Sets a bit.
+ *
+ * @param bitmap The bitmap.
+ * @param bit The bit to set.
+ */
+void bitmap_set(Bitmap bitmap, size_t bit);
+
+/**
+ * @brief Clears a bit.
+ *
+ * @param bitmap The bitmap.
+ * @param bit The bit to clear.
+ */
+void bitmap_clear(Bitmap bitmap, size_t bit);
+
+/**
+ * @brief Returns true iff a bit is set.
+ *
+ * @param bitmap The bitmap.
+ * @param bit The bit to test.
+ * @return true iff the bit is set.
+ */
+bool bitmap_test(Bitmap bitmap, size_t bit);
+
+/**
+ * @brief Clears all bits.
+ *
+ * @param bitmap The bitmap.
+ */
+void bitmap_clear_all(Bitmap bitmap);
+
+/**
+ * @brief Returns the first set bit at or after from, or -1 if there is none.
+ *
+ * Skips a whole word of clear bits at a time.
+ *
+ * @param bitmap The bitmap.
+ * @param from The first bit to consider.
+ * @return long The first set bit at or after from, or -1.
+ */
+long bitmap_next_set(Bitmap bitmap, size_t from);
+
+#endif
@@ -5,13 +5,30 @@
 #include "list.h"
 
 #define DEFAULT_SIZE 100
+#define DEFAULT_MAX_LOAD 0.8
+#define DEFAULT_MIN_LOAD 0.2
 
 typedef struct t_HashTable* HashTable;
 
+/**
+ * @brief The layout used to store and probe the entries of a hash table.
+ *
+ * HASH_TABLE_ROBIN_HOOD probes one slot at a time and resizes incrementally. HASH_TABLE_SWISS keeps a 7-bit hash
+ * fragment per slot and compares 16 of them per step (with SSE2 when available), which makes lookups, and especially
+ * misses, cheaper; it resizes in one pass.
+ *
+ * The program's own maps are typed tables from typed_hash_table.h. Both engines are kept for generic callers, and
+ * bench/hash_table.c runs and checks each of them.
+ */
+typedef enum {
+    HASH_TABLE_ROBIN_HOOD,
+    HASH_TABLE_SWISS
+} HashTableEngine;
+
 /**
  * @brief Creates a new hash table.
  * 
- * @param size The initial size of the hash table.
+ * @param size The initial number of slots, rounded up to a power of two.
  * @param hash The hash function to use.
  * @param key_equal The function to compare keys.
  * @param key_destroy The function to free keys.
@@ -19,6 +36,32 @@ typedef struct t_HashTable* HashTable;
  */
 HashTable hash_table_create(int size, int (*hash)(void*, int), bool (*key_equal)(void*, void*), void (*key_destroy)(void*));
 
+/**
+ * @brief Creates a new hash table that uses the given engine.
+ *
+ * @param engine The engine to use.
+ * @param size The initial number of slots, rounded up to a power of two.
+ * @param hash The hash function to use.
+ * @param key_equal The function to compare keys.
+ * @param key_destroy The function to free keys.
+ * @return HashTable The new hash table.
+ */
+HashTable hash_table_create_with_engine(HashTableEngine engine, int size, int (*hash)(void*, int), bool (*key_equal)(void*, void*), void (*key_destroy)(void*));
+
+/**
+ * @brief Sets the load factors that trigger resizing.
+ *
+ * The table doubles its number of slots when more than a max_load fraction of them is used, and halves it,
+ * never below its initial size, when less than min_load is used. Resizing is spread over the following inserts
+ * and removes, a few entries at a time. The defaults are DEFAULT_MAX_LOAD and DEFAULT_MIN_LOAD; a min_load of 0
+ * disables shrinking.
+ *
+ * @param htable The hash table.
+ * @param max_load The maximum fraction of used slots, below 1.
+ * @param min_load The minimum fraction of used slots.
+ */
+void hash_table_set_load_factors(HashTable htable, double max_load, double min_load);
+
 /**
  * @brief Destroys a hash table.
  * 
@@ -108,10 +151,12 @@ List hash_table_values(HashTable htable);
 List hash_table_entries(HashTable htable);
 
 /**
- * @brief Returns the entries of the hash table.
- * 
+ * @brief Resizes the hash table to new_size slots at once.
+ *
+ * Tables resize themselves as they fill; this is only needed to presize one before a known number of inserts.
+ *
  * @param htable The hash table.
- * @return List The entries of the hash table.
+ * @param new_size The new number of slots, rounded up to a power of two and to fit the current elements.
  */
 void hash_table_rehash(HashTable htable, int new_size);
 
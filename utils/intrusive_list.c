@@ -0,0 +1,59 @@
+#include "intrusive_list.h"
+
+void intrusive_list_init(IntrusiveList* list) {
+    list->first = NULL;
+    list->last = NULL;
+    list->size = 0;
+}
+
+bool intrusive_list_is_empty(IntrusiveList* list) {
+    return list->size == 0;
+}
+
+void intrusive_list_insert_first(IntrusiveList* list, IntrusiveLink* link) {
+    link->prev = NULL;
+    link->next = list->first;
+    if (list->first != NULL) {
+        list->first->prev = link;
+    } else {
+        list->last = link;
+    }
+    list->first = link;
+    list->size++;
+}
+
+void intrusive_list_insert_last(IntrusiveList* list, IntrusiveLink* link) {
+    link->next = NULL;
+    link->prev = list->last;
+    if (list->last != NULL) {
+        list->last->next = link;
+    } else {
+        list->first = link;
+    }
+    list->last = link;
+    list->size++;
+}
+
+void intrusive_list_remove(IntrusiveList* list, IntrusiveLink* link) {
+    if (link->prev != NULL) {
+        link->prev->next = link->next;
+    } else {
+        list->first = link->next;
+    }
+    if (link->next != NULL) {
+        link->next->prev = link->prev;
+    } else {
+        list->last = link->prev;
+    }
+    link->prev = NULL;
+    link->next = NULL;
+    list->size--;
+}
+
+IntrusiveLink* intrusive_list_first(IntrusiveList* list) {
+    return list->first;
+}
+
+IntrusiveLink* intrusive_list_next(IntrusiveLink* link) {
+    return link->next;
+}
@@ -0,0 +1,89 @@
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief The link an element embeds to be kept in an intrusive list.
+ *
+ * An element that embeds several links can be in several lists at once. The list never allocates: inserting,
+ * removing and walking only rewrite the links inside the elements.
+ */
+typedef struct IntrusiveLink_ {
+    struct IntrusiveLink_* prev;
+    struct IntrusiveLink_* next;
+} IntrusiveLink;
+
+/**
+ * @brief An intrusive list is a doubly linked sequence of links embedded in its elements.
+ *
+ * The list is a plain value with no pointers into itself, so it can be stored in arrays and copied while empty.
+ */
+typedef struct {
+    IntrusiveLink* first;
+    IntrusiveLink* last;
+    size_t size;
+} IntrusiveList;
+
+/**
+ * @brief Returns the element that embeds link as its field member.
+ */
+#define intrusive_list_entry(link, type, member) ((type*)((char*)(link) - offsetof(type, member)))
+
+/**
+ * @brief Initializes an empty intrusive list.
+ *
+ * @param list The list to initialize.
+ */
+void intrusive_list_init(IntrusiveList* list);
+
+/**
+ * @brief Returns true iff the list has no elements.
+ *
+ * @param list The list.
+ * @return true iff the list has no elements.
+ */
+bool intrusive_list_is_empty(IntrusiveList* list);
+
+/**
+ * @brief Inserts a link at the beginning of the list.
+ *
+ * @param list The list.
+ * @param link The link of the element to insert; it must not be in another list through this field.
+ */
+void intrusive_list_insert_first(IntrusiveList* list, IntrusiveLink* link);
+
+/**
+ * @brief Inserts a link at the end of the list.
+ *
+ * @param list The list.
+ * @param link The link of the element to insert; it must not be in another list through this field.
+ */
+void intrusive_list_insert_last(IntrusiveList* list, IntrusiveLink* link);
+
+/**
+ * @brief Removes a link from the list in O(1).
+ *
+ * @param list The list that contains the link.
+ * @param link The link to remove.
+ */
+void intrusive_list_remove(IntrusiveList* list, IntrusiveLink* link);
+
+/**
+ * @brief Returns the first link of the list, or NULL if it is empty.
+ *
+ * @param list The list.
+ * @return IntrusiveLink* The first link.
+ */
+IntrusiveLink* intrusive_list_first(IntrusiveList* list);
+
+/**
+ * @brief Returns the link following link, or NULL if it is the last one.
+ *
+ * @param link The current link.
+ * @return IntrusiveLink* The next link.
+ */
+IntrusiveLink* intrusive_list_next(IntrusiveLink* link);
+
+#endif
@@ -0,0 +1,259 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "inverted_index.h"
+
+#include "typed_hash_table.h"
+
+#define INITIAL_POSTINGS_CAPACITY 4
+#define INDEX_SIZE 4096
+#define INITIAL_QUERY_TOKENS 8
+
+/* The ids of one word, some of which may have been removed. The word is stored after them and freed with them. */
+typedef struct {
+    uint64_t* ids;
+    size_t size;
+    size_t capacity;
+    size_t num_removed;
+    char token[];
+} t_Postings, *Postings;
+
+DEFINE_TYPED_HASH_TABLE(PostingsMap, postings_map, const char*, Postings, typed_hash_string, typed_equal_string)
+
+struct InvertedIndex_ {
+    PostingsMap postings;
+    bool (*is_live)(uint64_t id, void* context);
+    void* context;
+    Postings* lists;
+    size_t lists_capacity;
+    uint64_t* results;
+    size_t results_capacity;
+};
+
+InvertedIndex inverted_index_create(bool (*is_live)(uint64_t id, void* context), void* context) {
+    InvertedIndex index = malloc(sizeof(struct InvertedIndex_));
+    postings_map_init(&index->postings, INDEX_SIZE);
+    index->is_live = is_live;
+    index->context = context;
+    index->lists_capacity = INITIAL_QUERY_TOKENS;
+    index->lists = malloc(sizeof(Postings) * index->lists_capacity);
+    index->results = NULL;
+    index->results_capacity = 0;
+    return index;
+}
+
+void _destroy_postings(Postings postings) {
+    free(postings->ids);
+    free(postings);
+}
+
+void inverted_index_destroy(InvertedIndex index) {
+    for (uint32_t i = 0; i < index->postings.capacity; i++) {
+        if (index->postings.slots[i].probe != 0) {
+            _destroy_postings(index->postings.slots[i].value);
+        }
+    }
+    postings_map_destroy(&index->postings);
+    free(index->lists);
+    free(index->results);
+    free(index);
+}
+
+bool _is_word_byte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+/* Copies the next word at or after *cursor into token, lowercased. Returns false when there are no more words. */
+bool _next_token(const char** cursor, const char* end, char token[MAX_TOKEN_LENGTH + 1]) {
+    const char* p = *cursor;
+    while (p < end && !_is_word_byte(*p)) {
+        p++;
+    }
+    if (p == end) {
+        *cursor = p;
+        return false;
+    }
+    size_t length = 0;
+    while (p < end && _is_word_byte(*p)) {
+        if (length < MAX_TOKEN_LENGTH) {
+            char c = *p;
+            token[length++] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+        }
+        p++;
+    }
+    token[length] = '\0';
+    *cursor = p;
+    return true;
+}
+
+/* Returns the position of the first id not less than id. */
+size_t _lower_bound(const uint64_t* ids, size_t size, uint64_t id) {
+    size_t low = 0, high = size;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (ids[middle] < id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void _postings_insert(Postings postings, uint64_t id) {
+    size_t position = postings->size;
+    if (position > 0 && postings->ids[position - 1] >= id) {
+        position = _lower_bound(postings->ids, postings->size, id);
+        if (postings->ids[position] == id) {
+            return;
+        }
+    }
+    if (postings->size == postings->capacity) {
+        postings->capacity *= 2;
+        postings->ids = realloc(postings->ids, sizeof(uint64_t) * postings->capacity);
+    }
+    memmove(postings->ids + position + 1, postings->ids + position, sizeof(uint64_t) * (postings->size - position));
+    postings->ids[position] = id;
+    postings->size++;
+}
+
+Postings _find_postings(InvertedIndex index, const char* token) {
+    Postings* postings = postings_map_get(&index->postings, token);
+    return postings != NULL ? *postings : NULL;
+}
+
+void inverted_index_add(InvertedIndex index, uint64_t id, const char* text, size_t length) {
+    char token[MAX_TOKEN_LENGTH + 1];
+    const char* end = text + length;
+    while (_next_token(&text, end, token)) {
+        Postings postings = _find_postings(index, token);
+        if (postings == NULL) {
+            size_t token_size = strlen(token) + 1;
+            postings = malloc(sizeof(t_Postings) + token_size);
+            postings->capacity = INITIAL_POSTINGS_CAPACITY;
+            postings->ids = malloc(sizeof(uint64_t) * postings->capacity);
+            postings->size = 0;
+            postings->num_removed = 0;
+            memcpy(postings->token, token, token_size);
+            postings_map_insert(&index->postings, postings->token, postings);
+        }
+        _postings_insert(postings, id);
+    }
+}
+
+/* Keeps only the live ids, and gives back memory once the array is mostly empty. */
+void _compact_postings(InvertedIndex index, Postings postings) {
+    size_t kept = 0;
+    for (size_t i = 0; i < postings->size; i++) {
+        if (index->is_live(postings->ids[i], index->context)) {
+            postings->ids[kept++] = postings->ids[i];
+        }
+    }
+    postings->size = kept;
+    postings->num_removed = 0;
+    size_t capacity = postings->capacity;
+    while (capacity > INITIAL_POSTINGS_CAPACITY && kept < capacity / 4) {
+        capacity /= 2;
+    }
+    if (capacity != postings->capacity) {
+        postings->capacity = capacity;
+        postings->ids = realloc(postings->ids, sizeof(uint64_t) * capacity);
+    }
+}
+
+/*
+ * Only counts the removal. A word repeated in the text is counted more than once, which at worst compacts its array
+ * early; compaction recounts from is_live.
+ */
+void inverted_index_remove(InvertedIndex index, uint64_t id, const char* text, size_t length) {
+    char token[MAX_TOKEN_LENGTH + 1];
+    const char* end = text + length;
+    while (_next_token(&text, end, token)) {
+        Postings postings = _find_postings(index, token);
+        if (postings == NULL) {
+            continue;
+        }
+        postings->num_removed++;
+        if (2 * postings->num_removed > postings->size) {
+            _compact_postings(index, postings);
+        }
+        if (postings->size == 0) {
+            postings_map_remove(&index->postings, postings->token, NULL);
+            _destroy_postings(postings);
+        }
+    }
+}
+
+int _compare_postings_size(const void* postings1, const void* postings2) {
+    size_t size1 = (*(Postings*)postings1)->size;
+    size_t size2 = (*(Postings*)postings2)->size;
+    return size1 < size2 ? -1 : size1 > size2;
+}
+
+/* Finds id in ids[from..size) by galloping forward from from, returning the first position not less than id. */
+size_t _gallop(const uint64_t* ids, size_t from, size_t size, uint64_t id) {
+    size_t step = 1;
+    size_t high = from;
+    while (high < size && ids[high] < id) {
+        from = high + 1;
+        high += step;
+        step *= 2;
+    }
+    if (high > size) {
+        high = size;
+    }
+    return from + _lower_bound(ids + from, high - from, id);
+}
+
+size_t inverted_index_search(InvertedIndex index, const char* query, const uint64_t** out_ids) {
+    Postings* lists = index->lists;
+    size_t num_lists = 0;
+    char token[MAX_TOKEN_LENGTH + 1];
+    const char* end = query + strlen(query);
+    while (_next_token(&query, end, token)) {
+        Postings postings = _find_postings(index, token);
+        if (postings == NULL) {
+            *out_ids = NULL;
+            return 0;
+        }
+        if (num_lists == index->lists_capacity) {
+            index->lists_capacity *= 2;
+            index->lists = lists = realloc(lists, sizeof(Postings) * index->lists_capacity);
+        }
+        lists[num_lists++] = postings;
+    }
+    if (num_lists == 0) {
+        *out_ids = NULL;
+        return 0;
+    }
+
+    /* Intersect starting from the rarest word, so the candidates only shrink. */
+    qsort(lists, num_lists, sizeof(Postings), _compare_postings_size);
+    if (index->results_capacity < lists[0]->size) {
+        index->results_capacity = lists[0]->size;
+        index->results = realloc(index->results, sizeof(uint64_t) * index->results_capacity);
+    }
+    memcpy(index->results, lists[0]->ids, sizeof(uint64_t) * lists[0]->size);
+    size_t num_results = lists[0]->size;
+    for (size_t i = 1; i < num_lists && num_results > 0; i++) {
+        size_t kept = 0, position = 0;
+        for (size_t j = 0; j < num_results && position < lists[i]->size; j++) {
+            position = _gallop(lists[i]->ids, position, lists[i]->size, index->results[j]);
+            if (position < lists[i]->size && lists[i]->ids[position] == index->results[j]) {
+                index->results[kept++] = index->results[j];
+            }
+        }
+        num_results = kept;
+    }
+
+    /* Removed ids are only dropped from the arrays lazily, so they are filtered out of the result. */
+    size_t num_live = 0;
+    for (size_t j = 0; j < num_results; j++) {
+        if (index->is_live(index->results[j], index->context)) {
+            index->results[num_live++] = index->results[j];
+        }
+    }
+    *out_ids = index->results;
+    return num_live;
+}
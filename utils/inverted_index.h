@@ -0,0 +1,77 @@
+#ifndef INVERTED_INDEX_H
+#define INVERTED_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MAX_TOKEN_LENGTH 64
+
+/**
+ * @brief An inverted index maps the words of documents to the ids of the documents containing them.
+ *
+ * Text is split into words at every byte that is not an ASCII letter, an ASCII digit, or part of a
+ * multi-byte UTF-8 character. ASCII letters are lowercased and words are truncated to
+ * MAX_TOKEN_LENGTH bytes. Each word keeps its ids in a sorted array.
+ *
+ * Removed documents are not taken out of those arrays straight away. The index asks the owner
+ * whether an id is still live: searches skip dead ids, and a word's array is compacted once its
+ * dead ids outnumber the live ones, or freed with the word when none are left. Ids must
+ * therefore never be reused.
+ */
+typedef struct InvertedIndex_* InvertedIndex;
+
+/**
+ * @brief Creates a new inverted index.
+ *
+ * @param is_live The function telling whether a document id has not been removed.
+ * @param context The context passed to is_live.
+ * @return InvertedIndex The new inverted index.
+ */
+InvertedIndex inverted_index_create(bool (*is_live)(uint64_t id, void* context), void* context);
+
+/**
+ * @brief Destroys an inverted index.
+ *
+ * @param index The inverted index to destroy.
+ */
+void inverted_index_destroy(InvertedIndex index);
+
+/**
+ * @brief Adds a document to the index.
+ *
+ * Appending is O(1) per word when ids are added in increasing order.
+ *
+ * @param index The inverted index.
+ * @param id The id of the document.
+ * @param text The text of the document.
+ * @param length The length of the text.
+ */
+void inverted_index_add(InvertedIndex index, uint64_t id, const char* text, size_t length);
+
+/**
+ * @brief Removes a document from the index.
+ *
+ * Call it once is_live reports the id as removed. Each word's array is compacted only when its
+ * dead ids outnumber the live ones, so removal is amortised O(1) per word.
+ *
+ * @param index The inverted index.
+ * @param id The id of the document.
+ * @param text The text the document was added with.
+ * @param length The length of the text.
+ */
+void inverted_index_remove(InvertedIndex index, uint64_t id, const char* text, size_t length);
+
+/**
+ * @brief Finds the documents that contain every word of a query.
+ *
+ * The returned array is owned by the index and is valid until the next search or change.
+ *
+ * @param index The inverted index.
+ * @param query The words to search for.
+ * @param out_ids The sorted ids of the matching documents.
+ * @return size_t The number of matching documents.
+ */
+size_t inverted_index_search(InvertedIndex index, const char* query, const uint64_t** out_ids);
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include "pool.h"
 
 /**
  * @brief A list is a sequence of pointers to elements.
@@ -18,6 +19,24 @@ typedef struct List_* List;
  */
 List list_create();
 
+/**
+ * @brief Creates a new list whose nodes are allocated from a pool.
+ *
+ * The pool may be shared by several lists and must outlive all of them. Lists derived from this one
+ * (joins, sublists, maps and filters) use the same pool.
+ *
+ * @param pool A pool created with list_pool_create, or NULL to allocate nodes with malloc.
+ * @return List The new list.
+ */
+List list_create_with_pool(Pool pool);
+
+/**
+ * @brief Creates a pool sized for list nodes.
+ *
+ * @return Pool The new pool, to be released with pool_destroy after the lists using it.
+ */
+Pool list_pool_create();
+
 /**
  * @brief Destroys a list.
  *
@@ -248,9 +267,56 @@ List list_map(List list, void* (*func)(void*));
  */
 List list_filter(List list, bool (*func)(void*));
 
+/**
+ * @brief Sorts the list in place.
+ *
+ * Stable bottom-up merge sort: O(n log n) comparisons, relinks the existing nodes and allocates no memory.
+ *
+ * @param list The linked list.
+ * @param compare The function to compare two elements, returning <0, 0 or >0.
+ */
+void list_sort(List list, int (*compare)(void*, void*));
+
+/**
+ * @brief A cursor over the elements of a list.
+ *
+ * Cursors live outside the list, usually on the stack, so any number of them can walk the same list at
+ * once: nested loops, or readers on several threads while nobody modifies the list. A cursor stays valid
+ * while the list is not changed, except that removing elements it has already passed is allowed.
+ */
+typedef struct {
+    struct Node_* next;
+} ListCursor;
+
+/**
+ * @brief Places a cursor before the first element of the list.
+ *
+ * @param list The linked list.
+ * @param cursor The cursor to start.
+ */
+void list_cursor_start(List list, ListCursor* cursor);
+
+/**
+ * @brief Returns true if the cursor has more elements.
+ *
+ * @param cursor The cursor.
+ * @return bool True if the cursor has more elements.
+ */
+bool list_cursor_has_next(ListCursor* cursor);
+
+/**
+ * @brief Returns the next element of the cursor and advances it.
+ *
+ * @param cursor The cursor.
+ * @return void* The next element, or NULL if the cursor is past the end.
+ */
+void* list_cursor_get_next(ListCursor* cursor);
+
 /**
  * @brief Starts the iteration of the list.
  *
+ * The list holds a single built-in cursor, so this iteration cannot be nested; use a ListCursor for that.
+ *
  * @param list The linked list.
  */
 void list_iterator_start(List list);
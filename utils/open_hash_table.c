@@ -1,35 +1,78 @@
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "hash_table.h"
+#include "string_hash.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "list.h"
 
+#define MIN_CAPACITY 8
+#define REHASH_STEP 4
+#define REHASH_MAX_VISITS 64
+#define FIBONACCI_MULTIPLIER 2654435769u
+/* Set in the probe length of entries removed from an array that is being migrated. */
+#define DEAD 0x80000000u
+#define GROUP_WIDTH 16
+#define CONTROL_EMPTY 0x80
+#define CONTROL_DELETED 0xfe
+
+/*
+ * Entries live directly in a flat array and are found by linear probing with Robin Hood ordering: an entry's probe
+ * length (1 in its home slot, 0 for an empty slot) never exceeds that of the entry before it by more than one. A
+ * lookup stops as soon as it reaches a slot whose entry is closer to home than the key would be, and removals shift
+ * the following entries back instead of leaving tombstones. The full hash is cached so most mismatches are rejected
+ * without calling key_equal.
+ */
 typedef struct {
     void* key;
     void* value;
-    bool (*key_equal)(void*, void*);
-    void (*key_destroy)(void*);
-} t_Item, *Item;
+    uint32_t hash;
+    uint32_t probe;
+} t_Slot, *Slot;
 
+/*
+ * The Swiss engine adds one control byte per slot: CONTROL_EMPTY, CONTROL_DELETED, or the low 7 bits of the mixed
+ * hash of the entry in it. Control bytes are scanned GROUP_WIDTH at a time, so a lookup compares a whole group of
+ * fragments in one step and only calls key_equal on the slots whose fragment matches. Its slots use probe 1 for full
+ * and 0 otherwise, so walks over the slots work for both engines.
+ */
+typedef struct {
+    Slot slots;
+    uint8_t* control;
+    uint32_t capacity;
+    uint32_t growth_left;
+    int shift;
+} SlotArray;
+
+/*
+ * Resizing is incremental: a new array is allocated, and every insert and remove moves a few entries of the old
+ * array into it. The old array is never reshuffled while it drains, so its probe sequences stay valid; slots below
+ * migrated have been moved, and entries removed before being moved are marked DEAD. Lookups search the old array,
+ * skipping those slots, and then the new one.
+ */
 struct t_HashTable {
-    int size;
+    HashTableEngine engine;
+    SlotArray table;
+    SlotArray old_table;
+    uint32_t migrated;
+    uint32_t min_capacity;
     int num_elements;
-    List* table;
+    double max_load;
+    double min_load;
     bool (*key_equal)(void*, void*);
     void (*key_destroy)(void*);
     int (*hash)(void*, int);
 };
 
 int _default_hash(void* key, int size) {
-    char* k = (char*)key;
-    int hash = 0;
-    int a = 127;
-    for (size_t i = 0; i < strlen(k); i++) {
-        hash = (hash * a + k[i]) % size;
-    }
-    return hash;
+    return (int)(string_hash((const char*)key) % (uint64_t)size);
 }
 
 bool _default_key_equal(void* key1, void* key2) {
@@ -38,28 +81,283 @@ bool _default_key_equal(void* key1, void* key2) {
     return strcmp(k1, k2) == 0;
 }
 
-bool _equal_item(void* item1, void* item2) {
-    Item i1 = (Item)item1;
-    Item i2 = (Item)item2;
-    return i1->key_equal(i1->key, i2->key);
+/* The caller's hash is taken modulo INT_MAX and spread over the array by Fibonacci hashing. */
+uint32_t _hash_key(HashTable htable, void* key) {
+    return (uint32_t)htable->hash(key, INT_MAX);
+}
+
+uint32_t _home(SlotArray* array, uint32_t hash) {
+    return (uint32_t)(hash * FIBONACCI_MULTIPLIER) >> array->shift;
+}
+
+void _create_slots(SlotArray* array, uint32_t capacity) {
+    uint32_t rounded = MIN_CAPACITY;
+    int bits = 3;
+    while (rounded < capacity) {
+        rounded *= 2;
+        bits++;
+    }
+    array->slots = calloc(rounded, sizeof(t_Slot));
+    array->control = NULL;
+    array->capacity = rounded;
+    array->growth_left = 0;
+    array->shift = 32 - bits;
+}
+
+void _destroy_slots(SlotArray* array) {
+    free(array->slots);
+    free(array->control);
+    array->slots = NULL;
+    array->control = NULL;
+    array->capacity = 0;
+}
+
+Slot _find_slot(HashTable htable, SlotArray* array, void* key, uint32_t hash, uint32_t skip_below) {
+    if (array->slots == NULL) {
+        return NULL;
+    }
+    uint32_t mask = array->capacity - 1;
+    uint32_t index = _home(array, hash);
+    for (uint32_t probe = 1;; probe++, index = (index + 1) & mask) {
+        Slot slot = &array->slots[index];
+        if ((slot->probe & ~DEAD) < probe) {
+            return NULL;
+        }
+        if (slot->hash == hash && !(slot->probe & DEAD) && index >= skip_below && htable->key_equal(slot->key, key)) {
+            return slot;
+        }
+    }
+}
+
+Slot _find(HashTable htable, void* key, uint32_t hash, SlotArray** array) {
+    Slot slot = _find_slot(htable, &htable->old_table, key, hash, htable->migrated);
+    if (slot != NULL) {
+        *array = &htable->old_table;
+        return slot;
+    }
+    *array = &htable->table;
+    return _find_slot(htable, &htable->table, key, hash, 0);
+}
+
+/* Places an entry whose key is known to be absent, displacing entries that are closer to their home slot. */
+void _place(SlotArray* array, void* key, void* value, uint32_t hash) {
+    t_Slot entry = {key, value, hash, 1};
+    uint32_t mask = array->capacity - 1;
+    uint32_t index = _home(array, hash);
+    for (;; entry.probe++, index = (index + 1) & mask) {
+        Slot slot = &array->slots[index];
+        if (slot->probe == 0) {
+            *slot = entry;
+            return;
+        }
+        if (slot->probe < entry.probe) {
+            t_Slot displaced = *slot;
+            *slot = entry;
+            entry = displaced;
+        }
+    }
+}
+
+void _shift_back(SlotArray* array, Slot slot) {
+    uint32_t mask = array->capacity - 1;
+    uint32_t index = slot - array->slots;
+    for (;;) {
+        Slot next = &array->slots[(index + 1) & mask];
+        if (next->probe <= 1) {
+            array->slots[index].probe = 0;
+            return;
+        }
+        array->slots[index] = *next;
+        array->slots[index].probe--;
+        index = (index + 1) & mask;
+    }
+}
+
+void _rehash_step(HashTable htable, uint32_t max_moves) {
+    SlotArray* old = &htable->old_table;
+    uint32_t moved = 0;
+    uint32_t visits = 0;
+    while (htable->migrated < old->capacity && moved < max_moves && visits < REHASH_MAX_VISITS * max_moves) {
+        Slot slot = &old->slots[htable->migrated++];
+        visits++;
+        if (slot->probe != 0 && !(slot->probe & DEAD)) {
+            _place(&htable->table, slot->key, slot->value, slot->hash);
+            moved++;
+        }
+    }
+    if (htable->migrated == old->capacity) {
+        _destroy_slots(old);
+        htable->migrated = 0;
+    }
+}
+
+void _finish_rehash(HashTable htable) {
+    while (htable->old_table.slots != NULL) {
+        _rehash_step(htable, UINT32_MAX / REHASH_MAX_VISITS);
+    }
+}
+
+void _start_rehash(HashTable htable, uint32_t new_capacity) {
+    _finish_rehash(htable);
+    htable->old_table = htable->table;
+    htable->migrated = 0;
+    _create_slots(&htable->table, new_capacity);
+}
+
+/* Grows or shrinks by a factor of two once the load leaves [min_load, max_load], never below the initial capacity. */
+void _check_load(HashTable htable) {
+    uint32_t capacity = htable->table.capacity;
+    if (htable->old_table.slots != NULL) {
+        _rehash_step(htable, REHASH_STEP);
+        if (htable->num_elements < htable->max_load * capacity) {
+            return;
+        }
+    }
+    if (htable->num_elements > htable->max_load * capacity) {
+        _start_rehash(htable, capacity * 2);
+    } else if (capacity / 2 >= htable->min_capacity && htable->num_elements < htable->min_load * capacity) {
+        _start_rehash(htable, capacity / 2);
+    }
+}
+
+uint32_t _group_match(const uint8_t* group, uint8_t value) {
+#ifdef __SSE2__
+    __m128i control = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8((char)value)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++) {
+        mask |= (uint32_t)(group[i] == value) << i;
+    }
+    return mask;
+#endif
+}
+
+/* Empty and deleted control bytes are the only ones with the high bit set. */
+uint32_t _group_match_free(const uint8_t* group) {
+#ifdef __SSE2__
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++) {
+        mask |= (uint32_t)(group[i] >> 7) << i;
+    }
+    return mask;
+#endif
+}
+
+void _create_swiss_slots(HashTable htable, SlotArray* array, uint32_t capacity) {
+    _create_slots(array, capacity < GROUP_WIDTH ? GROUP_WIDTH : capacity);
+    array->control = malloc(array->capacity);
+    memset(array->control, CONTROL_EMPTY, array->capacity);
+    array->growth_left = (uint32_t)(htable->max_load * array->capacity);
+    /* Groups are chosen by the high bits of the mixed hash, one group per GROUP_WIDTH slots. */
+    array->shift += 4;
+}
+
+uint32_t _swiss_group(SlotArray* array, uint32_t mixed) {
+    return (uint32_t)((uint64_t)mixed >> array->shift);
+}
+
+/* Groups are visited in triangular order, which reaches every group when their number is a power of two. */
+Slot _swiss_find(HashTable htable, SlotArray* array, void* key, uint32_t hash) {
+    uint32_t mixed = hash * FIBONACCI_MULTIPLIER;
+    uint8_t fragment = mixed & 0x7f;
+    uint32_t group_mask = array->capacity / GROUP_WIDTH - 1;
+    uint32_t group = _swiss_group(array, mixed);
+    for (uint32_t step = 1;; group = (group + step++) & group_mask) {
+        const uint8_t* control = array->control + group * GROUP_WIDTH;
+        for (uint32_t match = _group_match(control, fragment); match != 0; match &= match - 1) {
+            Slot slot = &array->slots[group * GROUP_WIDTH + __builtin_ctz(match)];
+            if (slot->hash == hash && htable->key_equal(slot->key, key)) {
+                return slot;
+            }
+        }
+        if (_group_match(control, CONTROL_EMPTY) != 0) {
+            return NULL;
+        }
+    }
+}
+
+void _swiss_place(SlotArray* array, void* key, void* value, uint32_t hash) {
+    uint32_t mixed = hash * FIBONACCI_MULTIPLIER;
+    uint32_t group_mask = array->capacity / GROUP_WIDTH - 1;
+    uint32_t group = _swiss_group(array, mixed);
+    uint32_t free_slots;
+    for (uint32_t step = 1; (free_slots = _group_match_free(array->control + group * GROUP_WIDTH)) == 0; step++) {
+        group = (group + step) & group_mask;
+    }
+    uint32_t index = group * GROUP_WIDTH + __builtin_ctz(free_slots);
+    if (array->control[index] == CONTROL_EMPTY) {
+        array->growth_left--;
+    }
+    array->control[index] = mixed & 0x7f;
+    t_Slot entry = {key, value, hash, 1};
+    array->slots[index] = entry;
 }
 
-Item _item_create(HashTable htable, void* key, void* value) {
-    Item item = malloc(sizeof(t_Item));
-    item->key = key;
-    item->value = value;
-    item->key_equal = htable->key_equal;
-    item->key_destroy = htable->key_destroy;
-    return item;
+/* Rebuilds the table at a new capacity in one pass, which also drops every deleted control byte. */
+void _swiss_resize(HashTable htable, uint32_t new_capacity) {
+    SlotArray old = htable->table;
+    _create_swiss_slots(htable, &htable->table, new_capacity);
+    for (uint32_t i = 0; i < old.capacity; i++) {
+        if (old.slots[i].probe != 0) {
+            _swiss_place(&htable->table, old.slots[i].key, old.slots[i].value, old.slots[i].hash);
+        }
+    }
+    _destroy_slots(&old);
+}
+
+void _swiss_insert(HashTable htable, void* key, void* value, uint32_t hash) {
+    SlotArray* array = &htable->table;
+    if (array->growth_left == 0) {
+        /* Out of empty slots: grow if the table is really full, otherwise only clear the deleted ones. */
+        uint32_t capacity = array->capacity;
+        if (htable->num_elements + 1 > htable->max_load * capacity / 2) {
+            capacity *= 2;
+        }
+        _swiss_resize(htable, capacity);
+    }
+    _swiss_place(&htable->table, key, value, hash);
+    htable->num_elements++;
+}
+
+/* A slot in a group that still has an empty byte can be emptied, since no probe sequence ever went past that group. */
+void _swiss_remove(HashTable htable, Slot slot) {
+    SlotArray* array = &htable->table;
+    uint32_t index = slot - array->slots;
+    if (_group_match(array->control + index / GROUP_WIDTH * GROUP_WIDTH, CONTROL_EMPTY) != 0) {
+        array->control[index] = CONTROL_EMPTY;
+        array->growth_left++;
+    } else {
+        array->control[index] = CONTROL_DELETED;
+    }
+    slot->probe = 0;
+    htable->num_elements--;
+    uint32_t capacity = array->capacity;
+    if (capacity / 2 >= htable->min_capacity && htable->num_elements < htable->min_load * capacity) {
+        _swiss_resize(htable, capacity / 2);
+    }
+}
+
+Slot _lookup(HashTable htable, void* key, uint32_t hash, SlotArray** array) {
+    if (htable->engine == HASH_TABLE_SWISS) {
+        *array = &htable->table;
+        return _swiss_find(htable, &htable->table, key, hash);
+    }
+    return _find(htable, key, hash, array);
 }
 
 HashTable hash_table_create(int size, int (*hash)(void*, int), bool (*key_equal)(void*, void*), void (*key_destroy)(void*)) {
+    return hash_table_create_with_engine(HASH_TABLE_ROBIN_HOOD, size, hash, key_equal, key_destroy);
+}
+
+HashTable hash_table_create_with_engine(HashTableEngine engine, int size, int (*hash)(void*, int), bool (*key_equal)(void*, void*), void (*key_destroy)(void*)) {
     HashTable htable = malloc(sizeof(struct t_HashTable));
+    htable->engine = engine;
     htable->num_elements = 0;
     if (size <= 0) {
-        htable->size = DEFAULT_SIZE;
-    } else {
-        htable->size = size;
+        size = DEFAULT_SIZE;
     }
     if (hash == NULL) {
         htable->hash = _default_hash;
@@ -72,93 +370,98 @@ HashTable hash_table_create(int size, int (*hash)(void*, int), bool (*key_equal)
         htable->key_equal = key_equal;
     }
     htable->key_destroy = key_destroy;
-
-    htable->table = malloc(sizeof(List) * htable->size);
-    for (int i = 0; i < htable->size; i++) {
-        htable->table[i] = list_create();
+    htable->max_load = DEFAULT_MAX_LOAD;
+    htable->min_load = DEFAULT_MIN_LOAD;
+    if (engine == HASH_TABLE_SWISS) {
+        _create_swiss_slots(htable, &htable->table, size);
+    } else {
+        _create_slots(&htable->table, size);
     }
+    htable->min_capacity = htable->table.capacity;
+    htable->old_table.slots = NULL;
+    htable->old_table.capacity = 0;
+    htable->migrated = 0;
     return htable;
 }
 
-void _destroy_item(void* item) {
-    Item i = (Item)item;
-    if (i->key_destroy != NULL) {
-        i->key_destroy(i->key);
-    }
-    free(i);
+void hash_table_set_load_factors(HashTable htable, double max_load, double min_load) {
+    htable->max_load = max_load;
+    htable->min_load = min_load;
 }
 
 void hash_table_destroy(HashTable htable, void (*value_destroy)(void*)) {
-    for (int i = 0; i < htable->size; i++) {
-        List list = htable->table[i];
-        list_iterator_start(list);
-        while (list_iterator_has_next(list)) {
-            Item item = list_iterator_get_next(list);
-            if (htable->key_destroy != NULL) {
-                htable->key_destroy(item->key);
-            }
-            if (item->value != NULL) {
-                if (value_destroy != NULL) {
-                    value_destroy(item->value);
-                }
+    _finish_rehash(htable);
+    for (uint32_t i = 0; i < htable->table.capacity; i++) {
+        Slot slot = &htable->table.slots[i];
+        if (slot->probe == 0) {
+            continue;
+        }
+        if (htable->key_destroy != NULL) {
+            htable->key_destroy(slot->key);
+        }
+        if (slot->value != NULL) {
+            if (value_destroy != NULL) {
+                value_destroy(slot->value);
             }
         }
-        list_destroy(list, _destroy_item);
     }
-    free(htable->table);
+    _destroy_slots(&htable->table);
     free(htable);
 }
 
 void hash_table_insert(HashTable htable, void* key, void* value) {
-    int index = htable->hash(key, htable->size) % htable->size;
-    List list = htable->table[index];
-    if (list_find(list, htable->key_equal, key) != -1) {
+    uint32_t hash = _hash_key(htable, key);
+    SlotArray* array;
+    if (_lookup(htable, key, hash, &array) != NULL) {
         return;
     }
-    Item item = _item_create(htable, key, value);
-    list_insert_last(list, item);
+    if (htable->engine == HASH_TABLE_SWISS) {
+        _swiss_insert(htable, key, value, hash);
+        return;
+    }
+    _place(&htable->table, key, value, hash);
     htable->num_elements++;
+    _check_load(htable);
 }
 
 void* hash_table_remove(HashTable htable, void* key) {
-    int index = htable->hash(key, htable->size) % htable->size;
-    List list = htable->table[index];
-    int position = list_find(list, htable->key_equal, key);
-    if (position == -1) {
+    SlotArray* array;
+    Slot slot = _lookup(htable, key, _hash_key(htable, key), &array);
+    if (slot == NULL) {
         return NULL;
     }
-    Item item = list_remove(list, position);
+    void* value = slot->value;
+    if (htable->engine == HASH_TABLE_SWISS) {
+        _swiss_remove(htable, slot);
+        return value;
+    }
+    if (array == &htable->old_table) {
+        slot->probe |= DEAD;
+    } else {
+        _shift_back(array, slot);
+    }
     htable->num_elements--;
-    void* value = item->value;
-    free(item);
+    _check_load(htable);
     return value;
 }
 
 void* hash_table_get(HashTable htable, void* key) {
-    int index = htable->hash(key, htable->size) % htable->size;
-    List list = htable->table[index];
-    Item item = _item_create(htable, key, NULL);
-    int position = list_find(list, _equal_item, item);
-    _destroy_item(item);
-    if (position == -1) {
+    SlotArray* array;
+    Slot slot = _lookup(htable, key, _hash_key(htable, key), &array);
+    if (slot == NULL) {
         return NULL;
     }
-    item = list_get(list, position);
-    return item->value;
+    return slot->value;
 }
 
 void* hash_table_update(HashTable htable, void* key, void* value) {
-    int index = htable->hash(key, htable->size) % htable->size;
-    List list = htable->table[index];
-    Item item = _item_create(htable, key, NULL);
-    int position = list_find(list, _equal_item, item);
-    free(item);
-    if (position == -1) {
+    SlotArray* array;
+    Slot slot = _lookup(htable, key, _hash_key(htable, key), &array);
+    if (slot == NULL) {
         return NULL;
     }
-    item = list_get(list, position);
-    void* old_value = item->value;
-    item->value = value;
+    void* old_value = slot->value;
+    slot->value = value;
     return old_value;
 }
 
@@ -171,39 +474,34 @@ bool hash_table_is_empty(HashTable htable) {
 }
 
 List hash_table_keys(HashTable htable) {
+    _finish_rehash(htable);
     List keys = list_create();
-    for (int i = 0; i < htable->size; i++) {
-        List list = htable->table[i];
-        list_iterator_start(list);
-        while (list_iterator_has_next(list)) {
-            Item item = list_iterator_get_next(list);
-            list_insert_last(keys, item->key);
+    for (uint32_t i = 0; i < htable->table.capacity; i++) {
+        if (htable->table.slots[i].probe != 0) {
+            list_insert_last(keys, htable->table.slots[i].key);
         }
     }
     return keys;
 }
 
 List hash_table_values(HashTable htable) {
+    _finish_rehash(htable);
     List values = list_create();
-    for (int i = 0; i < htable->size; i++) {
-        List list = htable->table[i];
-        list_iterator_start(list);
-        while (list_iterator_has_next(list)) {
-            Item item = list_iterator_get_next(list);
-            list_insert_last(values, item->value);
+    for (uint32_t i = 0; i < htable->table.capacity; i++) {
+        if (htable->table.slots[i].probe != 0) {
+            list_insert_last(values, htable->table.slots[i].value);
         }
     }
     return values;
 }
 
+/* Entries point into the table and are only valid until the next insert or remove. */
 List hash_table_entries(HashTable htable) {
+    _finish_rehash(htable);
     List entries = list_create();
-    for (int i = 0; i < htable->size; i++) {
-        List list = htable->table[i];
-        list_iterator_start(list);
-        while (list_iterator_has_next(list)) {
-            Item item = list_iterator_get_next(list);
-            list_insert_last(entries, item);
+    for (uint32_t i = 0; i < htable->table.capacity; i++) {
+        if (htable->table.slots[i].probe != 0) {
+            list_insert_last(entries, &htable->table.slots[i]);
         }
     }
     return entries;
@@ -213,18 +511,13 @@ void hash_table_rehash(HashTable htable, int new_size) {
     if (new_size <= 0) {
         return;
     }
-    HashTable new_htable = hash_table_create(new_size, htable->hash, htable->key_equal, htable->key_destroy);
-    for (int i = 0; i < htable->size; i++) {
-        List list = htable->table[i];
-        list_iterator_start(list);
-        while (list_iterator_has_next(list)) {
-            Item item = list_iterator_get_next(list);
-            hash_table_insert(new_htable, item->key, item->value);
-        }
-    }
-    hash_table_destroy(htable, NULL);
-    htable->size = new_htable->size;
-    htable->num_elements = new_htable->num_elements;
-    htable->table = new_htable->table;
-    free(new_htable);
-}
\ No newline at end of file
+    if ((uint32_t)new_size < htable->num_elements / htable->max_load) {
+        new_size = (int)(htable->num_elements / htable->max_load) + 1;
+    }
+    if (htable->engine == HASH_TABLE_SWISS) {
+        _swiss_resize(htable, new_size);
+        return;
+    }
+    _start_rehash(htable, new_size);
+    _finish_rehash(htable);
+}
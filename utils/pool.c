@@ -0,0 +1,72 @@
+#include <stdlib.h>
+
+#include "pool.h"
+
+typedef struct Slab_* Slab;
+struct Slab_ {
+    Slab next;
+    char* data;
+};
+
+/* Free objects are chained through their own first word. */
+typedef struct FreeObject_* FreeObject;
+struct FreeObject_ {
+    FreeObject next;
+};
+
+struct Pool_ {
+    size_t object_size;
+    size_t slab_objects;
+    Slab slabs;
+    size_t used;
+    FreeObject free_list;
+};
+
+Pool pool_create(size_t object_size, size_t slab_objects) {
+    Pool pool = malloc(sizeof(struct Pool_));
+    if (object_size < sizeof(struct FreeObject_)) {
+        object_size = sizeof(struct FreeObject_);
+    }
+    pool->object_size = (object_size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    if (slab_objects == 0) {
+        pool->slab_objects = POOL_DEFAULT_SLAB_OBJECTS;
+    } else {
+        pool->slab_objects = slab_objects;
+    }
+    pool->slabs = NULL;
+    pool->used = pool->slab_objects;
+    pool->free_list = NULL;
+    return pool;
+}
+
+void pool_destroy(Pool pool) {
+    Slab slab = pool->slabs;
+    while (slab != NULL) {
+        Slab next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    free(pool);
+}
+
+void* pool_alloc(Pool pool) {
+    if (pool->free_list != NULL) {
+        FreeObject object = pool->free_list;
+        pool->free_list = object->next;
+        return object;
+    }
+    if (pool->used == pool->slab_objects) {
+        Slab slab = malloc(sizeof(struct Slab_) + pool->object_size * pool->slab_objects);
+        slab->data = (char*)(slab + 1);
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pool->used = 0;
+    }
+    return pool->slabs->data + pool->object_size * pool->used++;
+}
+
+void pool_free(Pool pool, void* object) {
+    FreeObject freed = (FreeObject)object;
+    freed->next = pool->free_list;
+    pool->free_list = freed;
+}
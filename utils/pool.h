@@ -0,0 +1,51 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+#define POOL_DEFAULT_SLAB_OBJECTS 1024
+
+/**
+ * @brief A pool allocates objects of one fixed size out of large slabs.
+ *
+ * Freed objects are kept on a free list and handed out again before the current slab is used,
+ * so a steady insert/remove workload stops calling malloc once the pool is warm. Slabs are only
+ * released when the pool is destroyed.
+ */
+typedef struct Pool_* Pool;
+
+/**
+ * @brief Creates a new pool.
+ *
+ * @param object_size The size of every object allocated from the pool.
+ * @param slab_objects The number of objects per slab, or 0 for POOL_DEFAULT_SLAB_OBJECTS.
+ * @return Pool The new pool.
+ */
+Pool pool_create(size_t object_size, size_t slab_objects);
+
+/**
+ * @brief Destroys a pool.
+ *
+ * Frees all memory allocated from the pool, including objects that were never freed.
+ *
+ * @param pool The pool to destroy.
+ */
+void pool_destroy(Pool pool);
+
+/**
+ * @brief Allocates an object from the pool, aligned for any pointer-sized type.
+ *
+ * @param pool The pool.
+ * @return void* The allocated object.
+ */
+void* pool_alloc(Pool pool);
+
+/**
+ * @brief Returns an object to the pool.
+ *
+ * @param pool The pool the object was allocated from.
+ * @param object The object to free.
+ */
+void pool_free(Pool pool, void* object);
+
+#endif
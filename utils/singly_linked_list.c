@@ -3,6 +3,7 @@
 #include <stdlib.h>
 
 #include "list.h"
+#include "pool.h"
 
 typedef struct Node_* Node;
 struct Node_ {
@@ -14,29 +15,44 @@ struct List_ {
     Node head;
     Node tail;
     size_t size;
-    Node iterator;
+    ListCursor iterator;
+    Pool pool;
 };
 
-Node _create_node(void* element) {
-    Node node = malloc(sizeof(struct Node_));
+/* Lists created with a pool take their nodes from it; the others allocate each node with malloc. */
+Node _create_node(List list, void* element) {
+    Node node = list->pool != NULL ? pool_alloc(list->pool) : malloc(sizeof(struct Node_));
     node->next = NULL;
     node->element = element;
     return node;
 }
 
-void _destroy_node(Node node, void (*free_element)(void*)) {
+void _destroy_node(List list, Node node, void (*free_element)(void*)) {
     if (free_element != NULL) {
         free_element(node->element);
     }
-    free(node);
+    if (list->pool != NULL) {
+        pool_free(list->pool, node);
+    } else {
+        free(node);
+    }
+}
+
+Pool list_pool_create() {
+    return pool_create(sizeof(struct Node_), 0);
 }
 
 List list_create() {
+    return list_create_with_pool(NULL);
+}
+
+List list_create_with_pool(Pool pool) {
     List list = malloc(sizeof(struct List_));
+    list->pool = pool;
     list->head = NULL;
     list->tail = NULL;
     list->size = 0;
-    list->iterator = NULL;
+    list->iterator.next = NULL;
     return list;
 }
 
@@ -44,7 +60,7 @@ void list_destroy(List list, void (*free_element)(void*)) {
     Node node = list->head;
     while (node != NULL) {
         Node next = node->next;
-        _destroy_node(node, free_element);
+        _destroy_node(list, node, free_element);
         node = next;
     }
     free(list);
@@ -95,7 +111,7 @@ int list_find(List list, bool (*equal)(void*, void*), void* element) {
 }
 
 void list_insert_first(List list, void* element) {
-    Node node = _create_node(element);
+    Node node = _create_node(list, element);
     node->next = list->head;
     list->head = node;
     if (list_is_empty(list)) {
@@ -105,7 +121,7 @@ void list_insert_first(List list, void* element) {
 }
 
 void list_insert_last(List list, void* element) {
-    Node node = _create_node(element);
+    Node node = _create_node(list, element);
     if (list_is_empty(list)) {
         list->head = node;
     } else {
@@ -124,7 +140,7 @@ void list_insert(List list, void* element, int position) {
     } else if (position == list->size) {
         list_insert_last(list, element);
     } else {
-        Node node = _create_node(element);
+        Node node = _create_node(list, element);
         Node prev = list->head;
         for (size_t i = 0; i < position - 1; i++) {
             prev = prev->next;
@@ -145,7 +161,7 @@ void* list_remove_first(List list) {
         list->tail = NULL;
     }
     void* element = node->element;
-    _destroy_node(node, NULL);
+    _destroy_node(list, node, NULL);
     list->size--;
     return element;
 }
@@ -162,6 +178,8 @@ void* list_remove_last(List list) {
         while (node->next != list->tail) {
             node = node->next;
         }
+        _destroy_node(list, list->tail, NULL);
+        node->next = NULL;
         list->tail = node;
         list->size--;
     }
@@ -184,7 +202,7 @@ void* list_remove(List list, int position) {
     Node node = prev->next;
     void* element = node->element;
     prev->next = node->next;
-    _destroy_node(node, NULL);
+    _destroy_node(list, node, NULL);
     list->size--;
     return element;
 }
@@ -193,7 +211,7 @@ void list_make_empty(List list, void (*free_element)(void*)) {
     Node node = list->head;
     while (node != NULL) {
         Node next = node->next;
-        _destroy_node(node, free_element);
+        _destroy_node(list, node, free_element);
         node = next;
     }
     list->head = NULL;
@@ -236,7 +254,7 @@ int list_remove_all(List list, bool (*equal_element)(void*, void*), void (*free_
                 free_element(node->element);
             }
             next = node->next;
-            free(node);
+            _destroy_node(list, node, NULL);
             node = next;
             if (node == NULL) {
                 list->tail = previous;
@@ -267,7 +285,7 @@ int list_remove_duplicates(List list, bool (*equal_element)(void*, void*), void
                 if (free_element != NULL) {
                     free_element(node->element);
                 }
-                free(node);
+                _destroy_node(list, node, NULL);
                 node = next;
                 if (node == NULL) {
                     list->tail = previous;
@@ -286,7 +304,7 @@ int list_remove_duplicates(List list, bool (*equal_element)(void*, void*), void
 }
 
 List list_join(List list1, List list2) {
-    List list = list_create();
+    List list = list_create_with_pool(list1->pool);
     Node node = list1->head;
     while (node != NULL) {
         list_insert_last(list, node->element);
@@ -313,7 +331,7 @@ List list_get_sublist_between(List list, int start_idx, int end_idx) {
     if (end_idx < start_idx) {
         return NULL;
     }
-    List result = list_create();
+    List result = list_create_with_pool(list->pool);
     int idx = 0;
     Node node = list->head;
     while (idx < start_idx) {
@@ -332,7 +350,7 @@ List list_get_sublist(List list, int indexes[], int count) {
     if (count <= 0) {
         return NULL;
     }
-    List result = list_create();
+    List result = list_create_with_pool(list->pool);
     for (int i = 0; i < count; i++) {
         int target_idx = indexes[i];
         int current_idx = 0;
@@ -350,7 +368,7 @@ List list_map(List list, void* (*func)(void*)) {
     if (func == NULL) {
         return NULL;
     }
-    List l = list_create();
+    List l = list_create_with_pool(list->pool);
     Node node = list->head;
     while (node != NULL) {
         void* ret = func(node->element);
@@ -364,7 +382,7 @@ List list_filter(List list, bool (*func)(void*)) {
     if (func == NULL) {
         return NULL;
     }
-    List l = list_create();
+    List l = list_create_with_pool(list->pool);
     Node node = list->head;
     while (node != NULL) {
         if (func(node->element)) {
@@ -375,19 +393,83 @@ List list_filter(List list, bool (*func)(void*)) {
     return l;
 }
 
-void list_iterator_start(List list) {
-    list->iterator = list->head;
+/* Merges two sorted chains, taking from first on ties so that sorting is stable. */
+Node _merge_nodes(Node first, Node second, int (*compare)(void*, void*)) {
+    struct Node_ head;
+    Node tail = &head;
+    while (first != NULL && second != NULL) {
+        if (compare(first->element, second->element) <= 0) {
+            tail->next = first;
+            first = first->next;
+        } else {
+            tail->next = second;
+            second = second->next;
+        }
+        tail = tail->next;
+    }
+    tail->next = first != NULL ? first : second;
+    return head.next;
 }
 
-bool list_iterator_has_next(List list){
-    return list->iterator != NULL;
+void list_sort(List list, int (*compare)(void*, void*)) {
+    if (list->size < 2) {
+        return;
+    }
+    /*
+     * Bottom-up: runs[i] is either empty or a sorted chain of 2^i nodes. Each node is carried
+     * up through the occupied runs like a binary counter, so merges happen while the nodes
+     * involved are still in cache. Earlier nodes always sit in higher runs.
+     */
+    Node runs[sizeof(size_t) * 8] = {NULL};
+    Node node = list->head;
+    while (node != NULL) {
+        Node next = node->next;
+        node->next = NULL;
+        int i = 0;
+        for (; runs[i] != NULL; i++) {
+            node = _merge_nodes(runs[i], node, compare);
+            runs[i] = NULL;
+        }
+        runs[i] = node;
+        node = next;
+    }
+    Node head = NULL;
+    for (size_t i = 0; i < sizeof(runs) / sizeof(runs[0]); i++) {
+        if (runs[i] != NULL) {
+            head = head == NULL ? runs[i] : _merge_nodes(runs[i], head, compare);
+        }
+    }
+    list->head = head;
+    for (node = head; node->next != NULL; node = node->next) {
+    }
+    list->tail = node;
 }
 
-void* list_iterator_get_next(List list) {
-    if (list->iterator == NULL) {
+void list_cursor_start(List list, ListCursor* cursor) {
+    cursor->next = list->head;
+}
+
+bool list_cursor_has_next(ListCursor* cursor) {
+    return cursor->next != NULL;
+}
+
+void* list_cursor_get_next(ListCursor* cursor) {
+    if (cursor->next == NULL) {
         return NULL;
     }
-    void* element = list->iterator->element;
-    list->iterator = list->iterator->next;
+    void* element = cursor->next->element;
+    cursor->next = cursor->next->next;
     return element;
 }
+
+void list_iterator_start(List list) {
+    list_cursor_start(list, &list->iterator);
+}
+
+bool list_iterator_has_next(List list) {
+    return list_cursor_has_next(&list->iterator);
+}
+
+void* list_iterator_get_next(List list) {
+    return list_cursor_get_next(&list->iterator);
+}
@@ -0,0 +1,154 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "skip_list.h"
+
+#define MAX_LEVEL 32
+
+struct SkipListNode_ {
+    void* key;
+    void* value;
+    int level;
+    SkipListNode next[];
+};
+
+struct SkipList_ {
+    SkipListNode head;
+    int level;
+    size_t size;
+    uint64_t random_state;
+    int (*compare)(void*, void*);
+};
+
+SkipListNode _create_skip_node(void* key, void* value, int level) {
+    SkipListNode node = malloc(sizeof(struct SkipListNode_) + sizeof(SkipListNode) * level);
+    node->key = key;
+    node->value = value;
+    node->level = level;
+    for (int i = 0; i < level; i++) {
+        node->next[i] = NULL;
+    }
+    return node;
+}
+
+/* Each level is kept with probability 1/4, drawn from a xorshift generator owned by the list. */
+int _random_level(SkipList list) {
+    uint64_t x = list->random_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    list->random_state = x;
+    int level = 1;
+    while (level < MAX_LEVEL && (x & 3) == 0) {
+        level++;
+        x >>= 2;
+    }
+    return level;
+}
+
+/* Orders an entry against a key-value pair: by key, then by value. */
+int _compare_entry(SkipList list, SkipListNode node, void* key, void* value) {
+    int order = list->compare(node->key, key);
+    if (order != 0) {
+        return order;
+    }
+    return (uintptr_t)node->value < (uintptr_t)value ? -1 : (uintptr_t)node->value > (uintptr_t)value;
+}
+
+SkipList skip_list_create(int (*compare)(void*, void*)) {
+    SkipList list = malloc(sizeof(struct SkipList_));
+    list->head = _create_skip_node(NULL, NULL, MAX_LEVEL);
+    list->level = 1;
+    list->size = 0;
+    list->random_state = 0x9e3779b97f4a7c15ULL;
+    list->compare = compare;
+    return list;
+}
+
+void skip_list_destroy(SkipList list) {
+    SkipListNode node = list->head;
+    while (node != NULL) {
+        SkipListNode next = node->next[0];
+        free(node);
+        node = next;
+    }
+    free(list);
+}
+
+size_t skip_list_size(SkipList list) {
+    return list->size;
+}
+
+void skip_list_insert(SkipList list, void* key, void* value) {
+    SkipListNode update[MAX_LEVEL];
+    SkipListNode node = list->head;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (node->next[i] != NULL && _compare_entry(list, node->next[i], key, value) <= 0) {
+            node = node->next[i];
+        }
+        update[i] = node;
+    }
+    int level = _random_level(list);
+    for (int i = list->level; i < level; i++) {
+        update[i] = list->head;
+    }
+    if (level > list->level) {
+        list->level = level;
+    }
+    SkipListNode inserted = _create_skip_node(key, value, level);
+    for (int i = 0; i < level; i++) {
+        inserted->next[i] = update[i]->next[i];
+        update[i]->next[i] = inserted;
+    }
+    list->size++;
+}
+
+bool skip_list_remove(SkipList list, void* key, void* value) {
+    SkipListNode update[MAX_LEVEL];
+    SkipListNode node = list->head;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (node->next[i] != NULL && _compare_entry(list, node->next[i], key, value) < 0) {
+            node = node->next[i];
+        }
+        update[i] = node;
+    }
+    SkipListNode target = node->next[0];
+    if (target == NULL || _compare_entry(list, target, key, value) != 0) {
+        return false;
+    }
+    for (int i = 0; i < target->level; i++) {
+        update[i]->next[i] = target->next[i];
+    }
+    free(target);
+    while (list->level > 1 && list->head->next[list->level - 1] == NULL) {
+        list->level--;
+    }
+    list->size--;
+    return true;
+}
+
+SkipListNode skip_list_first(SkipList list) {
+    return list->head->next[0];
+}
+
+SkipListNode skip_list_lower_bound(SkipList list, void* key) {
+    SkipListNode node = list->head;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (node->next[i] != NULL && list->compare(node->next[i]->key, key) < 0) {
+            node = node->next[i];
+        }
+    }
+    return node->next[0];
+}
+
+SkipListNode skip_list_next(SkipListNode node) {
+    return node->next[0];
+}
+
+void* skip_list_key(SkipListNode node) {
+    return node->key;
+}
+
+void* skip_list_value(SkipListNode node) {
+    return node->value;
+}
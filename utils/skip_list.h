@@ -0,0 +1,106 @@
+#ifndef SKIP_LIST_H
+#define SKIP_LIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief A skip list is an ordered sequence of key-value pairs.
+ *
+ * Keys are ordered by a comparison function and may repeat; entries with equal keys are ordered
+ * by value, compared as unsigned integers, so every entry has its own position. Search,
+ * insertion and removal take O(log n) expected time, however many entries share a key.
+ */
+typedef struct SkipList_* SkipList;
+
+/**
+ * @brief A position in a skip list, used to walk its entries in order.
+ */
+typedef struct SkipListNode_* SkipListNode;
+
+/**
+ * @brief Creates a new skip list.
+ *
+ * @param compare The function to compare keys, returning <0, 0 or >0.
+ * @return SkipList The new skip list.
+ */
+SkipList skip_list_create(int (*compare)(void*, void*));
+
+/**
+ * @brief Destroys a skip list.
+ *
+ * Frees all memory allocated for the skip list, but not its keys or values.
+ *
+ * @param list The skip list to destroy.
+ */
+void skip_list_destroy(SkipList list);
+
+/**
+ * @brief Returns the number of entries in the skip list.
+ *
+ * @param list The skip list.
+ * @return size_t The number of entries in the skip list.
+ */
+size_t skip_list_size(SkipList list);
+
+/**
+ * @brief Inserts a key-value pair, after any entry with an equal key and an equal value.
+ *
+ * @param list The skip list.
+ * @param key The key.
+ * @param value The value.
+ */
+void skip_list_insert(SkipList list, void* key, void* value);
+
+/**
+ * @brief Removes the entry with an equal key and the given value.
+ *
+ * @param list The skip list.
+ * @param key The key.
+ * @param value The value.
+ * @return true iff an entry was removed.
+ */
+bool skip_list_remove(SkipList list, void* key, void* value);
+
+/**
+ * @brief Returns the first entry of the skip list, or NULL if it is empty.
+ *
+ * @param list The skip list.
+ * @return SkipListNode The first entry.
+ */
+SkipListNode skip_list_first(SkipList list);
+
+/**
+ * @brief Returns the first entry whose key is not less than the given key, or NULL if there is none.
+ *
+ * @param list The skip list.
+ * @param key The key.
+ * @return SkipListNode The first entry not less than key.
+ */
+SkipListNode skip_list_lower_bound(SkipList list, void* key);
+
+/**
+ * @brief Returns the entry following node, or NULL if node is the last one.
+ *
+ * @param node The current entry.
+ * @return SkipListNode The next entry.
+ */
+SkipListNode skip_list_next(SkipListNode node);
+
+/**
+ * @brief Returns the key of an entry.
+ *
+ * @param node The entry.
+ * @return void* The key of the entry.
+ */
+void* skip_list_key(SkipListNode node);
+
+/**
+ * @brief Returns the value of an entry.
+ *
+ * @param node The entry.
+ * @return void* The value of the entry.
+ */
+void* skip_list_value(SkipListNode node);
+
+#endif
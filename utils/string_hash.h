@@ -0,0 +1,35 @@
+#ifndef STRING_HASH_H
+#define STRING_HASH_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define STRING_HASH_SEED 0x243f6a8885a308d3ULL
+#define STRING_HASH_MULTIPLIER 0x9e3779b97f4a7c15ULL
+
+/*
+ * Hashes a null-terminated string eight bytes at a time: each word is folded into the state with a multiply and a
+ * shift, and the result goes through the MurmurHash3 finalizer so every input bit reaches every output bit. Shared
+ * by HashTable's default hash and typed_hash_string.
+ */
+static inline uint64_t string_hash(const char* key) {
+    size_t length = strlen(key);
+    uint64_t hash = STRING_HASH_SEED ^ (length * STRING_HASH_MULTIPLIER);
+    uint64_t word;
+    for (; length >= sizeof(word); key += sizeof(word), length -= sizeof(word)) {
+        memcpy(&word, key, sizeof(word));
+        hash = (hash ^ word) * STRING_HASH_MULTIPLIER;
+        hash ^= hash >> 32;
+    }
+    word = 0;
+    memcpy(&word, key, length);
+    hash = (hash ^ word) * STRING_HASH_MULTIPLIER;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+#endif
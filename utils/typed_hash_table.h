@@ -0,0 +1,188 @@
+#ifndef TYPED_HASH_TABLE_H
+#define TYPED_HASH_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "string_hash.h"
+
+/*
+ * DEFINE_TYPED_HASH_TABLE emits a hash table specialized for one key type and one value type. Keys and values are
+ * stored by value and the hash and equality functions are called directly, so the compiler can inline them into the
+ * probe loops; HashTable remains for keys that need void* and callbacks.
+ *
+ * The generated table uses linear probing with Robin Hood ordering and backward-shift removal over a flat
+ * power-of-two array, like the HASH_TABLE_ROBIN_HOOD engine, but grows in one pass. For
+ *
+ *     DEFINE_TYPED_HASH_TABLE(IdIndex, id_index, uint64_t, uint32_t, typed_hash_uint64, typed_equal_uint64)
+ *
+ * it defines the types IdIndex and IdIndexSlot and these functions:
+ *
+ *     void id_index_init(IdIndex* table, uint32_t capacity);
+ *     void id_index_destroy(IdIndex* table);
+ *     void id_index_reserve(IdIndex* table, uint32_t num_elements);
+ *     uint32_t* id_index_get(IdIndex* table, uint64_t key);        NULL if absent; valid until the next insert/remove
+ *     bool id_index_insert(IdIndex* table, uint64_t key, uint32_t value);     false if the key was already present
+ *     bool id_index_remove(IdIndex* table, uint64_t key, uint32_t* value);    stores the removed value unless NULL
+ *
+ * The entries are the slots with a non-zero probe in table->slots[0 .. table->capacity - 1].
+ */
+
+#define TYPED_HASH_TABLE_MIN_CAPACITY 16
+/* The table grows when more than 3/4 of its slots are used. */
+#define TYPED_HASH_TABLE_MAX_LOAD(capacity) ((capacity) - (capacity) / 4)
+
+static inline uint32_t typed_hash_uint64(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+static inline bool typed_equal_uint64(uint64_t key1, uint64_t key2) {
+    return key1 == key2;
+}
+
+static inline uint32_t typed_hash_string(const char* key) {
+    return (uint32_t)string_hash(key);
+}
+
+static inline bool typed_equal_string(const char* key1, const char* key2) {
+    return strcmp(key1, key2) == 0;
+}
+
+#define DEFINE_TYPED_HASH_TABLE(Name, prefix, KeyType, ValueType, hash_key, equal_keys)                                \
+    typedef struct {                                                                                                   \
+        KeyType key;                                                                                                   \
+        ValueType value;                                                                                               \
+        uint32_t hash;                                                                                                 \
+        uint32_t probe;                                                                                                \
+    } Name##Slot;                                                                                                      \
+                                                                                                                       \
+    typedef struct {                                                                                                   \
+        Name##Slot* slots;                                                                                             \
+        uint32_t capacity;                                                                                             \
+        uint32_t size;                                                                                                 \
+    } Name;                                                                                                            \
+                                                                                                                       \
+    static inline void prefix##_init(Name* table, uint32_t capacity) {                                                 \
+        uint32_t rounded = TYPED_HASH_TABLE_MIN_CAPACITY;                                                              \
+        while (rounded < capacity) {                                                                                   \
+            rounded *= 2;                                                                                              \
+        }                                                                                                              \
+        table->slots = calloc(rounded, sizeof(Name##Slot));                                                            \
+        table->capacity = rounded;                                                                                     \
+        table->size = 0;                                                                                               \
+    }                                                                                                                  \
+                                                                                                                       \
+    static inline void prefix##_destroy(Name* table) {                                                                 \
+        free(table->slots);                                                                                            \
+        table->slots = NULL;                                                                                           \
+        table->capacity = 0;                                                                                           \
+        table->size = 0;                                                                                               \
+    }                                                                                                                  \
+                                                                                                                       \
+    /* Fibonacci hashing spreads the hash over the array, so weak hashes such as small integers still scatter. */      \
+    static inline uint32_t prefix##_home(Name* table, uint32_t hash) {                                                 \
+        return (uint32_t)(((uint64_t)(hash * 2654435769u) * table->capacity) >> 32);                                   \
+    }                                                                                                                  \
+                                                                                                                       \
+    static inline void prefix##_place(Name* table, Name##Slot entry) {                                                 \
+        uint32_t mask = table->capacity - 1;                                                                           \
+        uint32_t index = prefix##_home(table, entry.hash);                                                             \
+        for (entry.probe = 1;; entry.probe++, index = (index + 1) & mask) {                                            \
+            Name##Slot* slot = &table->slots[index];                                                                   \
+            if (slot->probe == 0) {                                                                                    \
+                *slot = entry;                                                                                         \
+                return;                                                                                                \
+            }                                                                                                          \
+            if (slot->probe < entry.probe) {                                                                           \
+                Name##Slot displaced = *slot;                                                                          \
+                *slot = entry;                                                                                         \
+                entry = displaced;                                                                                     \
+            }                                                                                                          \
+        }                                                                                                              \
+    }                                                                                                                  \
+                                                                                                                       \
+    static inline void prefix##_resize(Name* table, uint32_t capacity) {                                               \
+        Name##Slot* slots = table->slots;                                                                              \
+        uint32_t old_capacity = table->capacity;                                                                       \
+        uint32_t size = table->size;                                                                                   \
+        prefix##_init(table, capacity);                                                                                \
+        table->size = size;                                                                                            \
+        for (uint32_t i = 0; i < old_capacity; i++) {                                                                  \
+            if (slots[i].probe != 0) {                                                                                 \
+                prefix##_place(table, slots[i]);                                                                       \
+            }                                                                                                          \
+        }                                                                                                              \
+        free(slots);                                                                                                   \
+    }                                                                                                                  \
+                                                                                                                       \
+    static inline void prefix##_reserve(Name* table, uint32_t num_elements) {                                          \
+        uint32_t capacity = table->capacity;                                                                           \
+        while (num_elements > TYPED_HASH_TABLE_MAX_LOAD(capacity)) {                                                   \
+            capacity *= 2;                                                                                             \
+        }                                                                                                              \
+        if (capacity != table->capacity) {                                                                             \
+            prefix##_resize(table, capacity);                                                                          \
+        }                                                                                                              \
+    }                                                                                                                  \
+                                                                                                                       \
+    static inline Name##Slot* prefix##_find(Name* table, KeyType key, uint32_t hash) {                                 \
+        uint32_t mask = table->capacity - 1;                                                                           \
+        uint32_t index = prefix##_home(table, hash);                                                                   \
+        for (uint32_t probe = 1;; probe++, index = (index + 1) & mask) {                                               \
+            Name##Slot* slot = &table->slots[index];                                                                   \
+            if (slot->probe < probe) {                                                                                 \
+                return NULL;                                                                                           \
+            }                                                                                                          \
+            if (slot->hash == hash && equal_keys(slot->key, key)) {                                                    \
+                return slot;                                                                                           \
+            }                                                                                                          \
+        }                                                                                                              \
+    }                                                                                                                  \
+                                                                                                                       \
+    static inline ValueType* prefix##_get(Name* table, KeyType key) {                                                  \
+        Name##Slot* slot = prefix##_find(table, key, hash_key(key));                                                   \
+        return slot != NULL ? &slot->value : NULL;                                                                     \
+    }                                                                                                                  \
+                                                                                                                       \
+    static inline bool prefix##_insert(Name* table, KeyType key, ValueType value) {                                    \
+        uint32_t hash = hash_key(key);                                                                                 \
+        if (prefix##_find(table, key, hash) != NULL) {                                                                 \
+            return false;                                                                                              \
+        }                                                                                                              \
+        prefix##_reserve(table, table->size + 1);                                                                      \
+        Name##Slot entry = {key, value, hash, 1};                                                                      \
+        prefix##_place(table, entry);                                                                                  \
+        table->size++;                                                                                                 \
+        return true;                                                                                                   \
+    }                                                                                                                  \
+                                                                                                                       \
+    static inline bool prefix##_remove(Name* table, KeyType key, ValueType* value) {                                   \
+        Name##Slot* slot = prefix##_find(table, key, hash_key(key));                                                   \
+        if (slot == NULL) {                                                                                            \
+            return false;                                                                                              \
+        }                                                                                                              \
+        if (value != NULL) {                                                                                           \
+            *value = slot->value;                                                                                      \
+        }                                                                                                              \
+        uint32_t mask = table->capacity - 1;                                                                           \
+        uint32_t index = slot - table->slots;                                                                          \
+        for (;;) {                                                                                                     \
+            Name##Slot* next = &table->slots[(index + 1) & mask];                                                      \
+            if (next->probe <= 1) {                                                                                    \
+                table->slots[index].probe = 0;                                                                         \
+                break;                                                                                                 \
+            }                                                                                                          \
+            table->slots[index] = *next;                                                                               \
+            table->slots[index].probe--;                                                                               \
+            index = (index + 1) & mask;                                                                                \
+        }                                                                                                              \
+        table->size--;                                                                                                 \
+        return true;                                                                                                   \
+    }
+
+#endif
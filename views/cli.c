@@ -1,45 +1,453 @@
 #include "cli.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "../controllers/task_list.h"
 #include "../models/tasks.h"
+#include "task_renderer.h"
 
-void run_cli() {
-    char* line = NULL;
-    size_t len = 0;
-    TaskList task_list = task_list_new();
-    while (true) {
-        getline(&line, &len, stdin);
-        char* command = strtok(line, " \n");
-        if (strcmp(command, "Q") == 0) {
-            break;
-        } else if (strcmp(command, "RT") == 0) {
-            char* description = strtok(NULL, "\n");
-            char* id = task_list_add_task(task_list, description);
-            printf("Tarefa criada com identificador %s.\n", id);
-        } else if (strcmp(command, "LT") == 0) {
-            Task* tasks = task_list_get_tasks(task_list);
-            int num_tasks = task_list_get_num_tasks(task_list);
-            for (int i = 0; i < num_tasks; i++) {
-                Task task = tasks[i];
-                if (task != NULL) {
-                    printf("%s %s %s\n", task_get_id(task), task_get_description(task), task_get_status(task));
-                }
-            }
-        } else if (strcmp(command, "MT") == 0) {
-            char* id = strtok(NULL, "\n");
-            task_list_complete_task(task_list, id);
-            printf("Tarefa %s marcada como completa.\n", id);
+/* Opcodes are the one or two letters of a command packed into an int, so dispatch is a single switch. */
+#define OPCODE(first, second) (((unsigned char)(first) << 8) | (unsigned char)(second))
+#define INVALID_OPCODE 0
+#define DEFAULT_COMPLETIONS 10
+#define INPUT_BUFFER_SIZE (64 * 1024)
+#define REPLY_BUFFER_SIZE (64 * 1024)
+
+/*
+ * Replies to commands that change the list are held until the log records they acknowledge are committed, so a
+ * crash never loses a task the user was told exists. They are released, after a sync, before the CLI blocks on
+ * input, before a listing, and once REPLY_BUFFER_SIZE bytes are held.
+ */
+typedef struct {
+    char* data;
+    size_t used;
+    size_t capacity;
+} Replies;
+
+void _reply(Replies* replies, const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    int length = vsnprintf(replies->data + replies->used, replies->capacity - replies->used, format, arguments);
+    va_end(arguments);
+    size_t needed = replies->used + length + 1;
+    if (needed > replies->capacity) {
+        while (needed > replies->capacity) {
+            replies->capacity *= 2;
+        }
+        replies->data = realloc(replies->data, replies->capacity);
+        va_start(arguments, format);
+        vsnprintf(replies->data + replies->used, replies->capacity - replies->used, format, arguments);
+        va_end(arguments);
+    }
+    replies->used += length;
+}
+
+/* Commits the log and only then writes the held replies to stdout. */
+void _release_replies(Replies* replies, TaskList task_list) {
+    bool synced = task_list_sync(task_list);
+    fwrite(replies->data, 1, replies->used, stdout);
+    replies->used = 0;
+    if (!synced) {
+        fflush(stdout);
+        fprintf(stderr, "Não foi possível gravar o registo.\n");
+    }
+}
+
+bool _parse_number(char* text, uint64_t* value) {
+    if (text == NULL || *text < '0' || *text > '9') {
+        return false;
+    }
+    char* end;
+    *value = strtoull(text, &end, 10);
+    return *end == '\0';
+}
+
+typedef struct {
+    TaskOrder order;
+    TaskFilter filter;
+    uint64_t start;
+    uint64_t count;
+    TaskRenderer renderer;
+} ListRequest;
+
+bool _parse_order(char* text, TaskOrder* order) {
+    if (strcmp(text, "id") == 0) {
+        *order = TASK_ORDER_ID;
+    } else if (strcmp(text, "estado") == 0) {
+        *order = TASK_ORDER_STATUS;
+    } else if (strcmp(text, "descricao") == 0) {
+        *order = TASK_ORDER_DESCRIPTION;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool _parse_status(char* text, int* status) {
+    if (strcmp(text, "pendente") == 0) {
+        *status = TASK_PENDING;
+    } else if (strcmp(text, "em_curso") == 0) {
+        *status = TASK_IN_PROGRESS;
+    } else if (strcmp(text, "completa") == 0) {
+        *status = TASK_COMPLETED;
+    } else if (strcmp(text, "cancelada") == 0) {
+        *status = TASK_CANCELLED;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/* Accepts "A-B", "A-", "-B" or a single id "A"; bounds are inclusive. */
+bool _parse_id_range(char* text, uint64_t* min_id, uint64_t* max_id) {
+    char* separator = strchr(text, '-');
+    if (separator == NULL) {
+        if (!_parse_number(text, min_id)) {
+            return false;
+        }
+        *max_id = *min_id;
+        return true;
+    }
+    *separator = '\0';
+    if (*text != '\0' && !_parse_number(text, min_id)) {
+        return false;
+    }
+    if (separator[1] != '\0' && !_parse_number(separator + 1, max_id)) {
+        return false;
+    }
+    return *min_id <= *max_id;
+}
+
+bool _parse_list_request(char* arguments, ListRequest* request) {
+    request->order = TASK_ORDER_ID;
+    request->filter.status = TASK_FILTER_ANY_STATUS;
+    request->filter.min_id = 0;
+    request->filter.max_id = UINT64_MAX;
+    request->filter.substring = NULL;
+    request->start = 0;
+    request->count = UINT64_MAX;
+    char* option = strtok(arguments, " ");
+    while (option != NULL) {
+        if (strncmp(option, "ordem=", 6) == 0) {
+            if (!_parse_order(option + 6, &request->order)) {
+                return false;
+            }
+        } else if (strncmp(option, "estado=", 7) == 0) {
+            if (!_parse_status(option + 7, &request->filter.status)) {
+                return false;
+            }
+        } else if (strncmp(option, "ids=", 4) == 0) {
+            if (!_parse_id_range(option + 4, &request->filter.min_id, &request->filter.max_id)) {
+                return false;
+            }
+        } else if (strncmp(option, "contem=", 7) == 0) {
+            /* The substring is the rest of the line, spaces included, so it must be the last option. */
+            char* rest = strtok(NULL, "");
+            if (rest != NULL) {
+                option[strlen(option)] = ' ';
+            }
+            if (option[7] == '\0') {
+                return false;
+            }
+            request->filter.substring = option + 7;
+            return true;
+        } else if (strncmp(option, "inicio=", 7) == 0) {
+            if (!_parse_number(option + 7, &request->start)) {
+                return false;
+            }
+        } else if (strncmp(option, "limite=", 7) == 0) {
+            if (!_parse_number(option + 7, &request->count)) {
+                return false;
+            }
         } else {
+            return false;
+        }
+        option = strtok(NULL, " ");
+    }
+    return true;
+}
+
+int _read_opcode(char* line, char** arguments) {
+    int opcode;
+    char* rest;
+    if (line[0] == '\0') {
+        return INVALID_OPCODE;
+    } else if (line[1] == '\0' || line[1] == ' ') {
+        opcode = OPCODE(line[0], 0);
+        rest = line + 1;
+    } else if (line[2] == '\0' || line[2] == ' ') {
+        opcode = OPCODE(line[0], line[1]);
+        rest = line + 2;
+    } else {
+        return INVALID_OPCODE;
+    }
+    *arguments = *rest == ' ' ? rest + 1 : rest;
+    return opcode;
+}
+
+void _register_task(TaskList task_list, Replies* replies, char* description) {
+    if (*description == '\0') {
+        _reply(replies, "Instrução inválida.\n");
+        return;
+    }
+    uint64_t id;
+    if (task_list_add_task(task_list, description, &id) == TASK_LIST_OK) {
+        _reply(replies, "Tarefa criada com identificador %" PRIu64 ".\n", id);
+    } else {
+        _reply(replies, "Não foi possível gravar o registo.\n");
+    }
+}
+
+bool _render_listed(Task task, void* context) {
+    ListRequest* request = (ListRequest*)context;
+    if (request->count == 0) {
+        return false;
+    }
+    if (request->start > 0) {
+        request->start--;
+        return true;
+    }
+    task_renderer_write(request->renderer, task);
+    request->count--;
+    return true;
+}
+
+void _list_tasks(TaskList task_list, TaskRenderer renderer, char* arguments) {
+    ListRequest request;
+    if (!_parse_list_request(arguments, &request)) {
+        printf("Instrução inválida.\n");
+        return;
+    }
+    request.renderer = renderer;
+    task_list_visit(task_list, request.order, &request.filter, _render_listed, &request);
+    task_renderer_flush(renderer);
+}
+
+bool _render_found(Task task, void* context) {
+    task_renderer_write((TaskRenderer)context, task);
+    return true;
+}
+
+void _search_tasks(TaskList task_list, TaskRenderer renderer, char* query) {
+    if (*query == '\0') {
+        printf("Instrução inválida.\n");
+        return;
+    }
+    task_list_search(task_list, query, _render_found, renderer);
+    task_renderer_flush(renderer);
+}
+
+void _autocomplete(TaskList task_list, TaskRenderer renderer, char* arguments) {
+    ListRequest request = {TASK_ORDER_DESCRIPTION, {TASK_FILTER_ANY_STATUS, 0, UINT64_MAX, NULL}, 0, DEFAULT_COMPLETIONS, renderer};
+    if (strncmp(arguments, "limite=", 7) == 0) {
+        char* prefix = strchr(arguments, ' ');
+        if (prefix != NULL) {
+            *prefix++ = '\0';
+        }
+        if (!_parse_number(arguments + 7, &request.count)) {
             printf("Instrução inválida.\n");
+            return;
         }
-        free(line);
-        line = NULL;
+        arguments = prefix != NULL ? prefix : "";
+    }
+    if (*arguments == '\0') {
+        printf("Instrução inválida.\n");
+        return;
+    }
+    task_list_visit_prefix(task_list, arguments, _render_listed, &request);
+    task_renderer_flush(renderer);
+}
+
+void _summarize_tasks(TaskList task_list, TaskRenderer renderer) {
+    for (TaskStatus status = 0; status < NUM_TASK_STATUSES; status++) {
+        task_renderer_write_count(renderer, status, task_list_count_status(task_list, status));
+    }
+    task_renderer_flush(renderer);
+    printf("Total: %d\n", task_list_get_num_tasks(task_list));
+}
+
+void _report_change(Replies* replies, TaskListResult result, uint64_t id, const char* done) {
+    if (result == TASK_LIST_OK) {
+        _reply(replies, "Tarefa %" PRIu64 " %s.\n", id, done);
+    } else if (result == TASK_LIST_NOT_FOUND) {
+        _reply(replies, "Tarefa %" PRIu64 " não existe.\n", id);
+    } else {
+        _reply(replies, "Não foi possível gravar o registo.\n");
+    }
+}
+
+void _complete_task(TaskList task_list, Replies* replies, char* arguments) {
+    uint64_t id;
+    if (!_parse_number(arguments, &id)) {
+        _reply(replies, "Instrução inválida.\n");
+    } else {
+        _report_change(replies, task_list_complete_task(task_list, id), id, "marcada como completa");
+    }
+}
+
+void _delete_task(TaskList task_list, Replies* replies, char* arguments) {
+    uint64_t id;
+    if (!_parse_number(arguments, &id)) {
+        _reply(replies, "Instrução inválida.\n");
+    } else {
+        _report_change(replies, task_list_delete_task(task_list, id), id, "eliminada");
     }
-    if (line != NULL) {
-        free(line);
+}
+
+void _import_tasks(TaskList task_list, Replies* replies, char* path) {
+    if (*path == '\0') {
+        _reply(replies, "Instrução inválida.\n");
+        return;
+    }
+    long num_imported;
+    TaskListResult result = task_list_import(task_list, path, &num_imported);
+    if (result == TASK_LIST_OK) {
+        _reply(replies, "%ld tarefas importadas.\n", num_imported);
+    } else if (result == TASK_LIST_NOT_FOUND) {
+        _reply(replies, "Não foi possível importar %s.\n", path);
+    } else {
+        _reply(replies, "Não foi possível gravar o registo; %ld tarefas importadas de %s.\n", num_imported, path);
+    }
+}
+
+void _save_tasks(TaskList task_list, Replies* replies, const char* snapshot_path, char* path) {
+    bool saved;
+    if (*path != '\0') {
+        saved = task_list_save(task_list, path);
+    } else if (snapshot_path != NULL) {
+        path = (char*)snapshot_path;
+        saved = task_list_checkpoint(task_list, path);
+    } else {
+        _reply(replies, "Instrução inválida.\n");
+        return;
+    }
+    if (saved) {
+        _reply(replies, "Tarefas gravadas em %s.\n", path);
+    } else {
+        _reply(replies, "Não foi possível gravar %s.\n", path);
+    }
+}
+
+/* Input is read in blocks straight from the file descriptor, so the CLI can tell when the next line would block. */
+typedef struct {
+    char* data;
+    size_t start;
+    size_t end;
+    size_t capacity;
+} Input;
+
+/*
+ * Scripted input is committed to the log in groups, but a group is never held while waiting for input: before a
+ * read that would block, the pending records are synced and only then are their replies shown. A person typing
+ * therefore sees each reply once its command is committed.
+ */
+void _release_before_blocking(Replies* replies, TaskList task_list) {
+    struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+    if (poll(&input, 1, 0) == 0) {
+        _release_replies(replies, task_list);
+        fflush(stdout);
+    }
+}
+
+/* Returns the next line without its newline, or NULL at the end of the input. */
+char* _read_line(Input* input, Replies* replies, TaskList task_list) {
+    size_t scanned = input->start;
+    for (;;) {
+        char* newline = memchr(input->data + scanned, '\n', input->end - scanned);
+        if (newline != NULL) {
+            char* line = input->data + input->start;
+            *newline = '\0';
+            input->start = newline + 1 - input->data;
+            return line;
+        }
+        /* Move the partial line to the front of the buffer, growing it if the line fills it. */
+        scanned = input->end - input->start;
+        memmove(input->data, input->data + input->start, scanned);
+        input->start = 0;
+        input->end = scanned;
+        if (input->end == input->capacity) {
+            input->capacity *= 2;
+            input->data = realloc(input->data, input->capacity + 1);
+        }
+        _release_before_blocking(replies, task_list);
+        ssize_t length = read(STDIN_FILENO, input->data + input->end, input->capacity - input->end);
+        if (length < 0 && errno == EINTR) {
+            continue;
+        }
+        if (length <= 0) {
+            if (input->end == 0) {
+                return NULL;
+            }
+            /* The last line has no newline. */
+            input->data[input->end] = '\0';
+            input->start = input->end;
+            return input->data;
+        }
+        input->end += length;
+    }
+}
+
+void run_cli(TaskList task_list, const char* snapshot_path) {
+    Input input = {malloc(INPUT_BUFFER_SIZE + 1), 0, 0, INPUT_BUFFER_SIZE};
+    Replies replies = {malloc(REPLY_BUFFER_SIZE), 0, REPLY_BUFFER_SIZE};
+    char* line;
+    bool running = true;
+    TaskRenderer renderer = task_renderer_new(stdout);
+    while (running && (line = _read_line(&input, &replies, task_list)) != NULL) {
+        char* arguments;
+        int opcode = _read_opcode(line, &arguments);
+        /* Listings show uncommitted changes too, so they are written straight to stdout only after a release. */
+        if (opcode == OPCODE('L', 'T') || opcode == OPCODE('P', 'T') || opcode == OPCODE('A', 'T') ||
+            opcode == OPCODE('S', 'T')) {
+            _release_replies(&replies, task_list);
+        }
+        switch (opcode) {
+            case OPCODE('Q', 0):
+                running = false;
+                break;
+            case OPCODE('R', 'T'):
+                _register_task(task_list, &replies, arguments);
+                break;
+            case OPCODE('L', 'T'):
+                _list_tasks(task_list, renderer, arguments);
+                break;
+            case OPCODE('M', 'T'):
+                _complete_task(task_list, &replies, arguments);
+                break;
+            case OPCODE('P', 'T'):
+                _search_tasks(task_list, renderer, arguments);
+                break;
+            case OPCODE('A', 'T'):
+                _autocomplete(task_list, renderer, arguments);
+                break;
+            case OPCODE('S', 'T'):
+                _summarize_tasks(task_list, renderer);
+                break;
+            case OPCODE('E', 'T'):
+                _delete_task(task_list, &replies, arguments);
+                break;
+            case OPCODE('I', 'T'):
+                _import_tasks(task_list, &replies, arguments);
+                break;
+            case OPCODE('G', 'T'):
+                _save_tasks(task_list, &replies, snapshot_path, arguments);
+                break;
+            default:
+                _reply(&replies, "Instrução inválida.\n");
+                break;
+        }
+        if (replies.used >= REPLY_BUFFER_SIZE) {
+            _release_replies(&replies, task_list);
+        }
     }
-    task_list_destroy(task_list);
+    _release_replies(&replies, task_list);
+    free(replies.data);
+    free(input.data);
+    task_renderer_destroy(renderer);
 }
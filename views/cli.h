@@ -1,6 +1,8 @@
 #ifndef CLI_H
 #define CLI_H
 
-void run_cli();
+#include "../controllers/task_list.h"
+
+void run_cli(TaskList task_list, const char* snapshot_path);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "task_renderer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define RENDER_BUFFER_SIZE (64 * 1024)
+#define MAX_ID_DIGITS 20
+
+/* Rows are formatted into one buffer and written to the output in RENDER_BUFFER_SIZE chunks. */
+struct TaskRenderer_ {
+    FILE* out;
+    size_t used;
+    char buffer[RENDER_BUFFER_SIZE];
+};
+
+typedef struct {
+    char* text;
+    size_t length;
+} StatusText;
+
+StatusText _status_texts[] = {
+    [TASK_PENDING] = {"Por completar", sizeof("Por completar") - 1},
+    [TASK_IN_PROGRESS] = {"Em curso", sizeof("Em curso") - 1},
+    [TASK_COMPLETED] = {"Completa", sizeof("Completa") - 1},
+    [TASK_CANCELLED] = {"Cancelada", sizeof("Cancelada") - 1},
+    [TASK_DELETED] = {"Eliminada", sizeof("Eliminada") - 1},
+};
+
+TaskRenderer task_renderer_new(FILE* out) {
+    TaskRenderer renderer = malloc(sizeof(struct TaskRenderer_));
+    renderer->out = out;
+    renderer->used = 0;
+    return renderer;
+}
+
+void task_renderer_destroy(TaskRenderer renderer) {
+    task_renderer_flush(renderer);
+    free(renderer);
+}
+
+void task_renderer_flush(TaskRenderer renderer) {
+    if (renderer->used > 0) {
+        fwrite(renderer->buffer, 1, renderer->used, renderer->out);
+        renderer->used = 0;
+    }
+    fflush(renderer->out);
+}
+
+size_t _format_id(uint64_t id, char* out) {
+    char digits[MAX_ID_DIGITS];
+    size_t length = 0;
+    do {
+        digits[MAX_ID_DIGITS - ++length] = '0' + id % 10;
+        id /= 10;
+    } while (id != 0);
+    memcpy(out, digits + MAX_ID_DIGITS - length, length);
+    return length;
+}
+
+void _append(TaskRenderer renderer, const char* data, size_t length) {
+    if (renderer->used + length > RENDER_BUFFER_SIZE) {
+        fwrite(renderer->buffer, 1, renderer->used, renderer->out);
+        renderer->used = 0;
+        if (length > RENDER_BUFFER_SIZE) {
+            fwrite(data, 1, length, renderer->out);
+            return;
+        }
+    }
+    memcpy(renderer->buffer + renderer->used, data, length);
+    renderer->used += length;
+}
+
+void task_renderer_write(TaskRenderer renderer, Task task) {
+    StatusText status = _status_texts[task_get_status(task)];
+    size_t description_length = task_get_description_length(task);
+    size_t row_length = MAX_ID_DIGITS + 1 + description_length + 1 + status.length + 1;
+    if (renderer->used + row_length > RENDER_BUFFER_SIZE) {
+        fwrite(renderer->buffer, 1, renderer->used, renderer->out);
+        renderer->used = 0;
+    }
+    if (row_length > RENDER_BUFFER_SIZE) {
+        char id[MAX_ID_DIGITS + 1];
+        size_t id_length = _format_id(task_get_id(task), id);
+        id[id_length++] = ' ';
+        _append(renderer, id, id_length);
+        _append(renderer, task_get_description(task), description_length);
+        _append(renderer, " ", 1);
+        _append(renderer, status.text, status.length);
+        _append(renderer, "\n", 1);
+        return;
+    }
+    char* out = renderer->buffer + renderer->used;
+    out += _format_id(task_get_id(task), out);
+    *out++ = ' ';
+    memcpy(out, task_get_description(task), description_length);
+    out += description_length;
+    *out++ = ' ';
+    memcpy(out, status.text, status.length);
+    out += status.length;
+    *out++ = '\n';
+    renderer->used = out - renderer->buffer;
+}
+
+void task_renderer_write_count(TaskRenderer renderer, TaskStatus status, int count) {
+    StatusText text = _status_texts[status];
+    char number[MAX_ID_DIGITS];
+    _append(renderer, text.text, text.length);
+    _append(renderer, ": ", 2);
+    _append(renderer, number, _format_id((uint64_t)count, number));
+    _append(renderer, "\n", 1);
+}
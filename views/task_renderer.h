@@ -0,0 +1,19 @@
+#ifndef TASK_RENDERER_H
+#define TASK_RENDERER_H
+
+#include <stdio.h>
+#include "../models/tasks.h"
+
+typedef struct TaskRenderer_* TaskRenderer;
+
+TaskRenderer task_renderer_new(FILE* out);
+
+void task_renderer_destroy(TaskRenderer renderer);
+
+void task_renderer_write(TaskRenderer renderer, Task task);
+
+void task_renderer_write_count(TaskRenderer renderer, TaskStatus status, int count);
+
+void task_renderer_flush(TaskRenderer renderer);
+
+#endif